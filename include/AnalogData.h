@@ -0,0 +1,117 @@
+///
+/// \file AnalogData.h
+/// \brief Contiguous storage of analog channels
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef ANALOGDATA_H
+#define ANALOGDATA_H
+
+#include <string>
+#include <vector>
+
+#include "Settings.h"
+
+namespace C3D
+{
+const uint				NO_CHANNEL = ~0u;				///< channel missing from the file
+
+///
+/// \class AnalogData
+/// \brief Samples of all analog channels over all frames.
+///
+/// Each channel owns one contiguous column of getNumSamples() floats, the
+/// samples of frame f start at f * getSamplesPerFrame(). Values are scaled
+/// with the ANALOG:OFFSET, ANALOG:SCALE and ANALOG:GEN_SCALE of the file.
+///
+class AnalogData
+{
+private:
+	uint						_numChannels;		///< # of channels
+	uint						_numFrames;			///< # of frames
+	uint						_samplesPerFrame;	///< analog samples per frame
+	float						_sampleRate;		///< samples per second
+	std::vector<float>			_samples;			///< [channel][frame * samplesPerFrame + sample]
+	std::vector<std::string>	_labels;			///< label of each channel
+
+public:
+	///
+	/// \brief Constructor of an empty set of channels
+	///
+	AnalogData();
+	///
+	/// \brief resize the channels, all samples 0 and no labels
+	///	\param numChannels: # of channels
+	///	\param numFrames: # of frames
+	///	\param samplesPerFrame: analog samples per frame
+	///
+	void resize(uint numChannels, uint numFrames, uint samplesPerFrame);
+	///
+	/// \brief get the number of channels
+	///	\return # of channels
+	///
+	uint getNumChannels() const { return _numChannels; }
+	///
+	/// \brief get the number of frames
+	///	\return # of frames
+	///
+	uint getNumFrames() const { return _numFrames; }
+	///
+	/// \brief get the number of analog samples per frame
+	///	\return # of samples
+	///
+	uint getSamplesPerFrame() const { return _samplesPerFrame; }
+	///
+	/// \brief get the number of samples of each channel
+	///	\return getNumFrames() * getSamplesPerFrame()
+	///
+	uint getNumSamples() const { return _numFrames * _samplesPerFrame; }
+	///
+	/// \brief get the sample rate
+	///	\return samples per second, 0 if unknown
+	///
+	float getSampleRate() const { return _sampleRate; }
+	///
+	/// \brief set the sample rate
+	///	\param sampleRate: samples per second
+	///
+	void setSampleRate(float sampleRate);
+	///
+	/// \brief get all samples of a channel
+	///	\param channel: channel index
+	///	\return getNumSamples() contiguous values
+	///
+	const float * getChannel(uint channel) const { return _samples.data() + std::size_t(channel) * getNumSamples(); }
+	float * getChannel(uint channel) { return _samples.data() + std::size_t(channel) * getNumSamples(); }
+	///
+	/// \brief get one sample
+	///	\param channel: channel index
+	///	\param frame: frame index
+	///	\param sample: sample index within the frame
+	///	\return value
+	///
+	float getSample(uint channel, uint frame, uint sample) const { return getChannel(channel)[frame * _samplesPerFrame + sample]; }
+	///
+	/// \brief get the label of a channel
+	///	\param channel: channel index
+	///	\return label, empty if the file has none
+	///
+	std::string getLabel(uint channel) const { return _labels[channel]; }
+	///
+	/// \brief set the label of a channel
+	///	\param channel: channel index
+	///	\param label: label without padding
+	///
+	void setLabel(uint channel, std::string label);
+	///
+	/// \brief find a channel from its label
+	///	\param label: label without padding
+	///	\return channel index, NO_CHANNEL if there is no such label
+	///
+	uint findChannel(std::string label) const;
+}; // End of class AnalogData
+
+}; // end of namespace C3D
+
+#endif
\ No newline at end of file
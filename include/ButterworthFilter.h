@@ -0,0 +1,98 @@
+///
+/// \file ButterworthFilter.h
+/// \brief Zero-phase low-pass filtering of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef BUTTERWORTHFILTER_H
+#define BUTTERWORTHFILTER_H
+
+#include <vector>
+#include <map>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+const uint				FILTER_MAX_ORDER = 8;			///< highest order of the Butterworth design
+const uint				FILTER_LANES = 4;				///< columns filtered together, sharing the same valid run
+
+///
+/// \struct BiquadSection
+/// \brief Second order section, y = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2) x
+///
+struct BiquadSection
+{
+	double		b0;					///< numerator
+	double		b1;
+	double		b2;
+	double		a1;					///< denominator, a0 = 1
+	double		a2;
+};
+
+///
+/// \class ButterworthFilter
+/// \brief Butterworth low-pass run forwards and backwards (filtfilt), so the positions are not delayed.
+///
+/// The filter is a cascade of second order sections designed by the bilinear
+/// transform at the frame rate of each trajectory. Every valid run of a
+/// marker is filtered on its own, padded at both ends by odd reflection and
+/// started from the steady state of its first sample, so gaps never leak
+/// into the valid samples. The x, y and z columns of a marker share their
+/// runs and are filtered together, FILTER_LANES columns at a time, along
+/// with the columns of other markers with the same runs. As the response is
+/// applied twice, the gain at the cutoff is -6 dB.
+///
+class ButterworthFilter
+{
+	uint											_order;			///< order of the design
+	float											_cutoff;		///< cutoff frequency in Hz
+	uint											_numThreads;	///< # of worker threads of applyAll
+
+public:
+	///
+	/// \brief Constructor
+	///	\param order: order in [1, FILTER_MAX_ORDER]
+	///	\param cutoff: cutoff frequency in Hz, below half the frame rate
+	///	\param numThreads: # of worker threads of applyAll, 0 for one per hardware thread
+	///
+	ButterworthFilter(uint order = 4, float cutoff = 6.0f, uint numThreads = 0);
+
+	///
+	/// \brief design the sections for a frame rate
+	///	\param frameRate: frames per second
+	///	\return (order + 1) / 2 sections, empty if the cutoff is not below half the frame rate
+	///
+	std::vector<BiquadSection> getSections(float frameRate) const;
+
+	///
+	/// \brief filter every valid run of every marker in place, invalid samples are left untouched
+	///	\param trajectory: marker data
+	///	\return false if the cutoff is not below half the frame rate of the trajectory
+	///
+	bool apply(Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief filter many trajectories concurrently
+	///	\param trajectories: captures to filter in place
+	///	\return # of trajectories filtered
+	///
+	uint applyAll(std::map<SequenceKey, Marker::Trajectory> & trajectories) const;
+
+	///
+	/// \brief filter forwards and backwards columns covering the same frames
+	///	\param sections: cascade of sections
+	///	\param columns: up to FILTER_LANES columns, filtered in place
+	///	\param numColumns: # of columns
+	///	\param length: # of frames
+	///	\param scratch: work buffer, resized as needed
+	///
+	static void filterColumns(const std::vector<BiquadSection> & sections, float * const * columns, uint numColumns, uint length, std::vector<double> & scratch);
+};
+
+};
+
+#endif
\ No newline at end of file
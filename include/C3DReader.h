@@ -9,16 +9,21 @@
 #define C3DREADER_H
 
 #include <vector>
-#include <map>
 #include <memory>
 
 #include "Settings.h"
 #include "MarkerData.h"
+#include "Trajectory.h"
+#include "AnalogData.h"
+#include "TrajectoryArchive.h"
+#include "MarkerLayout.h"
 #include "uuc3d.hpp"
 #include "basic_io.hpp"
 
 namespace C3D
 {
+class MappedC3DFile;
+
 ///
 /// \class C3DReader
 /// \brief Reading and writing of c3d files
@@ -27,7 +32,11 @@ class C3DReader
 {
 	uint											_frameRate;		///< frame rate
 	uint											_numMarkers;	///< # of markers in c3d file
-	UuIcsC3d::C3dFileInfo *							_fileInfo;		///< file info
+	std::shared_ptr<const UuIcsC3d::C3dFileInfo>	_fileInfo;		///< header template shared by all readers, NULL if missing
+	std::vector<uint>								_markerSubset;	///< point indices to read, all if empty
+	std::vector<std::string>						_labelSubset;	///< point labels to read, resolved per file
+	std::shared_ptr<const MarkerLayout>				_layoutSubset;	///< body part markers to read, resolved per label set
+	bool											_useCache;		///< read and write trajectory caches
 
 public:
 	///
@@ -38,18 +47,115 @@ public:
 	C3DReader(uint numMarkers, uint frameRate);
 public:
 	///
-	/// \brief write to a C3D file
-	///	\param numMarkers: 
-	///	\param frameRate:
+	/// \brief read only some of the points, in the given order
+	///	\param markers: point indices
+	///
+	void setMarkerSubset(std::vector<uint> markers);
+
+	///
+	/// \brief read only some of the points, in the given order
+	///	\param labels: point labels, looked up in each file
+	///
+	void setMarkerSubset(std::vector<std::string> labels);
+
+	///
+	/// \brief read only the markers of the body parts, in layout order, see LabelResolver
+	///	\param layout: marker names
+	///
+	void setMarkerSubset(const MarkerLayout & layout);
+
+	///
+	/// \brief read all points again
 	///
-	void writeToC3D(std::string fileName, std::vector<UuIcsC3d::FrameData> data);
+	void clearMarkerSubset();
+
+	///
+	/// \brief use the binary trajectory cache next to each c3d file, enabled by default
+	///	\param useCache: true to read valid caches and write missing or stale ones
+	///
+	void setCacheEnabled(bool useCache);
+
+	///
+	/// \brief write to a C3D file, frames are streamed to the file by a C3DWriter
+	///	\param fileName: c3d file to create
+	///	\param data: frames to write
+	///
+	void writeToC3D(std::string fileName, const std::vector<UuIcsC3d::FrameData> & data);
 	
 	///
 	/// \brief Read all frames from a C3D file
 	///	\param fileName:
-	///	\return 
+	///	\return trajectory of the selected points, every point if no subset is set
+	///
+	Marker::Trajectory readAllFrames(std::string fileName);
+
+	///
+	/// \brief Read a window of frames, only the frames of the window are decoded
+	///	\param fileName:
+	///	\param firstFrame: first frame (0 based)
+	///	\param lastFrame: frame after the last one, clamped to the end of the file
+	///	\return trajectory of the selected points, its first frame is firstFrame
+	///
+	Marker::Trajectory readFrameWindow(std::string fileName, uint firstFrame, uint lastFrame);
+
+	///
+	/// \brief Read a window of frames of a file kept open, e.g. while scrubbing through a capture
+	///	\param file: opened c3d file
+	///	\param firstFrame: first frame (0 based)
+	///	\param lastFrame: frame after the last one, clamped to the end of the file
+	///	\return trajectory of the selected points, its first frame is firstFrame
+	///
+	Marker::Trajectory readFrameWindow(const MappedC3DFile & file, uint firstFrame, uint lastFrame);
+
+	///
+	/// \brief Read all points of a C3D file through a memory mapping
+	///	\param fileName:
+	///	\param positions: caller-owned buffer, resized to frames * selected points * 3 (x, y, z)
+	///	\param residuals: caller-owned buffer, resized to frames * selected points (-1 if invalid)
+	///	\return # of frames read
+	///
+	uint readAllPoints(std::string fileName, std::vector<float> & positions, std::vector<float> & residuals);
+
+	///
+	/// \brief Read all analog channels of a C3D file in one pass
+	///	\param fileName:
+	///	\return channel-major samples, empty if the file has no analog data
+	///
+	AnalogData readAnalog(std::string fileName);
+
+	///
+	/// \brief Compress every point of a C3D file into a trajectory archive
+	///	\param fileName: c3d file
+	///	\param archiveFileName: archive to create
+	///	\param options: precision and predictor
+	///	\return true if written
+	///
+	bool writeArchive(std::string fileName, std::string archiveFileName, ArchiveOptions options = ArchiveOptions());
+
+	///
+	/// \brief Read a trajectory archive, only the columns of the selected points are decoded
+	///	\param archiveFileName:
+	///	\return trajectory of the selected points, every point if no subset is set
+	///
+	Marker::Trajectory readArchive(std::string archiveFileName);
+
+private:
+	///
+	/// \brief get the points to read from a file
+	///	\param pointLabels: labels of all points of the file
+	///	\return point indices, out of range for labels not in the file
+	///
+	std::vector<uint> selectMarkers(const std::vector<std::string> & pointLabels);
+
+	///
+	/// \brief decode some of the points of a window of frames
+	///	\param file: opened c3d file
+	///	\param markers: point indices
+	///	\param firstFrame: first frame (0 based)
+	///	\param numFrames: # of frames, within the file
+	///	\return trajectory of the points
 	///
-	std::vector<std::map<uint, Marker::MarkerData > > readAllFrames(std::string fileName);
+	Marker::Trajectory decodeFrames(const MappedC3DFile & file, const std::vector<uint> & markers, uint firstFrame, uint numFrames);
 };
 
 };
@@ -0,0 +1,135 @@
+///
+/// \file C3DWriter.h
+/// \brief Incremental writing of c3d files
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef C3DWRITER_H
+#define C3DWRITER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "uuc3d.hpp"
+#include "basic_io.hpp"
+
+namespace C3D
+{
+///
+/// \class C3DWriter
+/// \brief Appends frames to a c3d file without keeping the capture in memory.
+///
+/// The header and parameter section are copied from a template when the file
+/// is opened, frames are buffered and written in whole 512-byte blocks, and
+/// the frame count is patched when the file is closed. Points are written as
+/// Intel floats.
+///
+class C3DWriter
+{
+	std::ofstream									_file;				///< output file
+	std::string										_fileName;			///< name of the output file
+	std::vector<unsigned char>						_buffer;			///< frames not yet written
+	std::map<std::string, std::streamoff>			_patchOffsets;		///< file offsets of the parameters patched on close
+	boost::shared_ptr<UuIcsC3d::BasicIO>			_encoder;			///< Intel encoder
+	bool											_native;			///< platform encoding is Intel
+	uint											_numPoints;			///< # of points per frame
+	uint											_analogChannels;	///< # of analog channels
+	uint											_analogSamples;		///< analog samples per frame
+	float											_pointScale;		///< residual scale
+	uint											_frameCount;		///< # of frames appended
+
+public:
+	///
+	/// \brief Constructor, writes the header and parameter section
+	///	\param fileName: c3d file to create
+	///	\param fileTemplate: header and parameters to copy, including the # of points and analog channels
+	///	\param frameRate: frame rate, 0 to keep the one of the template
+	///
+	C3DWriter(std::string fileName, const UuIcsC3d::C3dFileInfo & fileTemplate, float frameRate = 0);
+
+	///
+	/// \brief Destructor, closes the file
+	///
+	~C3DWriter();
+
+	///
+	/// \brief checks if frames can be appended
+	///	\return true if open
+	///
+	bool isOpen() const;
+
+	///
+	/// \brief get the number of frames appended so far
+	///	\return # of frames
+	///
+	uint getFrameCount() const;
+
+	///
+	/// \brief append one frame
+	///	\param frame: points (and analog data) of the frame
+	///	\return false if the file is not open or cannot be written
+	///
+	bool writeFrame(const UuIcsC3d::FrameData & frame);
+
+	///
+	/// \brief append a block of frames
+	///	\param frames: frames in order
+	///	\return false if the file is not open or cannot be written
+	///
+	bool writeFrames(const std::vector<UuIcsC3d::FrameData> & frames);
+
+	///
+	/// \brief append frames of a trajectory, analog data is written as 0
+	///	\param trajectory: one marker per point of the file
+	///	\param firstFrame: first frame of the trajectory
+	///	\param numFrames: # of frames
+	///	\return false if the file is not open or cannot be written
+	///
+	bool writeFrames(const Marker::Trajectory & trajectory, uint firstFrame, uint numFrames);
+
+	///
+	/// \brief flush the frames, pad the last block and patch the frame count
+	///	\return false if the file could not be completed
+	///
+	bool close();
+
+private:
+	///
+	/// \brief append one point to the buffer
+	///	\param position: x y z
+	///	\param status: Measured, Generated or Invalid
+	///	\param residual: residual of the point
+	///	\param mask: camera mask
+	///
+	void appendPoint(const float * position, UuIcsC3d::DataPoint3d::Status status, float residual, unsigned char mask);
+
+	///
+	/// \brief append one float to the buffer
+	///	\param value: value to encode
+	///
+	void appendFloat(float value);
+
+	///
+	/// \brief write the whole blocks of the buffer
+	///	\return false if the file cannot be written
+	///
+	bool flushBlocks();
+
+	///
+	/// \brief serialise the header block and the parameter section
+	///	\param fileTemplate: header and parameters to copy
+	///	\param frameRate: frame rate
+	///	\param out: bytes of the blocks
+	///	\return false if a required parameter is missing
+	///
+	bool writeHeader(const UuIcsC3d::C3dFileInfo & fileTemplate, float frameRate, std::vector<unsigned char> & out);
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+///
+/// \file DatasetCatalogue.h
+/// \brief Catalogue of the header data of the c3d files of the dataset
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef DATASETCATALOGUE_H
+#define DATASETCATALOGUE_H
+
+#include <vector>
+#include <string>
+
+#include "Settings.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+///
+/// \struct CatalogueEntry
+/// \brief Header data of one capture
+///
+struct CatalogueEntry
+{
+	SequenceKey					key;				///< capture
+	std::string					fileName;			///< c3d file
+	bool						found;				///< false if the file could not be parsed
+	uint						frameCount;			///< # of frames
+	uint						numPoints;			///< # of points per frame
+	float						frameRate;			///< frames per second
+	uint						analogChannels;		///< # of analog channels
+	uint						analogSamples;		///< analog samples per frame
+	std::vector<std::string>	pointLabels;		///< one label per point
+
+	CatalogueEntry(SequenceKey key, std::string fileName) :
+		key(key),
+		fileName(fileName),
+		found(false),
+		frameCount(0),
+		numPoints(0),
+		frameRate(0),
+		analogChannels(0),
+		analogSamples(0)
+	{
+	}
+};
+
+///
+/// \class DatasetCatalogue
+/// \brief Scans the header block and parameter section of many c3d files concurrently.
+///
+/// No frame data is read. The catalogue file is tab separated, one line per
+/// capture found, with the point labels joined by commas in the last column.
+///
+class DatasetCatalogue
+{
+	uint											_numThreads;	///< # of worker threads
+	std::vector<CatalogueEntry>						_entries;		///< entries sorted by key
+
+public:
+	///
+	/// \brief Constructor
+	///	\param numThreads: # of worker threads, 0 for one per hardware thread
+	///
+	DatasetCatalogue(uint numThreads = 0);
+
+	///
+	/// \brief scan some captures, replacing the current entries
+	///	\param keys: captures to scan
+	///	\return # of files found
+	///
+	uint scan(std::vector<SequenceKey> keys);
+
+	///
+	/// \brief scan every capture of every subject
+	///	\return # of files found
+	///
+	uint scanAll();
+
+	///
+	/// \brief get the entries of the last scan or read
+	///	\return entries sorted by key, including the files not found
+	///
+	const std::vector<CatalogueEntry> & getEntries() const;
+
+	///
+	/// \brief write the entries found to a catalogue file
+	///	\param fileName: catalogue file
+	///	\return false if the file cannot be written
+	///
+	bool write(std::string fileName) const;
+
+	///
+	/// \brief read a catalogue file, replacing the current entries
+	///	\param fileName: catalogue file
+	///	\return false if the file cannot be read
+	///
+	bool read(std::string fileName);
+
+	///
+	/// \brief parse the header data of one file
+	///	\param entry: key and file name set, the rest is filled in
+	///
+	static void scanFile(CatalogueEntry & entry);
+};
+
+};
+
+#endif
\ No newline at end of file
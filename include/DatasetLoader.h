@@ -0,0 +1,142 @@
+///
+/// \file DatasetLoader.h
+/// \brief Parallel loading of the c3d files of the dataset
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef DATASETLOADER_H
+#define DATASETLOADER_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <functional>
+
+#include "Settings.h"
+#include "C3DReader.h"
+#include "Trajectory.h"
+
+namespace C3D
+{
+///
+/// \struct SequenceKey
+/// \brief Identifies one capture of the dataset
+///
+struct SequenceKey
+{
+	uint subject;				///< subject # (1 based)
+	uint sequence;				///< sequence # (1 based) or one of CalibrationSequences
+
+	SequenceKey(uint subject, uint sequence) :
+		subject(subject),
+		sequence(sequence)
+	{
+	}
+
+	bool operator<(const SequenceKey & other) const
+	{
+		return subject < other.subject || (subject == other.subject && sequence < other.sequence);
+	}
+};
+
+///
+/// \struct LoadTiming
+/// \brief Time spent on one file
+///
+struct LoadTiming
+{
+	SequenceKey		key;			///< capture
+	std::string		fileName;		///< c3d file
+	double			seconds;		///< wall time of the load
+	uint			numFrames;		///< # of frames read
+	bool			loaded;			///< false if the file could not be read
+
+	LoadTiming(SequenceKey key, std::string fileName) :
+		key(key),
+		fileName(fileName),
+		seconds(0.0),
+		numFrames(0),
+		loaded(false)
+	{
+	}
+};
+
+///
+/// \class DatasetLoader
+/// \brief Decodes many c3d files concurrently on a thread pool
+///
+class DatasetLoader
+{
+	C3DReader										_reader;		///< shared reader, holds the marker subset
+	uint											_numThreads;	///< # of worker threads
+	uint											_maxInFlight;	///< max # of files being decoded or queued
+	std::vector<LoadTiming>							_timings;		///< timings of the last load
+
+public:
+	///
+	/// \brief Constructor
+	///	\param numThreads: # of worker threads, 0 for one per hardware thread
+	///	\param maxInFlight: max # of files being decoded or queued, 0 for twice the # of threads
+	///
+	DatasetLoader(uint numThreads = 0, uint maxInFlight = 0);
+
+	///
+	/// \brief get the reader used for every file, e.g. to set a marker subset
+	///	\return reader
+	///
+	C3DReader & getReader();
+
+	///
+	/// \brief load a list of captures
+	///	\param keys: captures to load
+	///	\return trajectories of the captures that could be read
+	///
+	std::map<SequenceKey, Marker::Trajectory> load(std::vector<SequenceKey> keys);
+
+	///
+	/// \brief load all sequences and calibration captures of a subject
+	///	\param subjectNumber: subject #
+	///	\return trajectories of the captures that could be read
+	///
+	std::map<SequenceKey, Marker::Trajectory> loadSubject(uint subjectNumber);
+
+	///
+	/// \brief load all sequences and calibration captures of all subjects
+	///	\return trajectories of the captures that could be read
+	///
+	std::map<SequenceKey, Marker::Trajectory> loadAll();
+
+	///
+	/// \brief read captures in the background while processing the previous ones, keeping at most depth trajectories in memory
+	///	\param keys: captures to process, in order
+	///	\param processor: called on the calling thread for every capture that could be read
+	///	\param depth: max # of captures read ahead of the processor
+	///	\return # of captures processed
+	///
+	uint process(std::vector<SequenceKey> keys, std::function<void(SequenceKey, Marker::Trajectory &)> processor, uint depth = 2);
+
+	///
+	/// \brief get the per-file timings of the last load, ordered by key
+	///	\return timings
+	///
+	const std::vector<LoadTiming> & getTimings() const;
+
+	///
+	/// \brief get the c3d file of a capture
+	///	\param key: capture
+	///	\return file name
+	///
+	static std::string getFileName(SequenceKey key);
+
+	///
+	/// \brief get the keys of all captures of a subject
+	///	\param subjectNumber: subject #
+	///	\return sequences followed by the calibration captures
+	///
+	static std::vector<SequenceKey> getSubjectKeys(uint subjectNumber);
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+///
+/// \file DecodeKernels.h
+/// \brief Bulk conversion of the point words of c3d frames
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef DECODEKERNELS_H
+#define DECODEKERNELS_H
+
+#include "Settings.h"
+#include "basic_io.hpp"
+
+namespace C3D
+{
+const uint				DECODE_CHUNK_POINTS = 256;		///< points converted per pass through the scratch buffer
+
+///
+/// \enum InstructionSet
+/// \brief Kernels available to the decoder, chosen once at runtime
+///
+enum InstructionSet
+{
+	ISA_SCALAR,				///< portable C++
+	ISA_SSE41,				///< SSSE3 and SSE4.1
+	ISA_AVX2				///< AVX2
+};
+
+///
+/// \brief get the kernels used by decodePoints and computeOrientations, the best the CPU supports unless overridden
+///	\return instruction set
+///
+InstructionSet getInstructionSet();
+
+///
+/// \brief override the kernels used by decodePoints and computeOrientations, e.g. to compare them
+///	\param instructionSet: requested kernels, lowered to what the CPU supports
+///	\return kernels now in use
+///
+InstructionSet setInstructionSet(InstructionSet instructionSet);
+
+///
+/// \brief decode consecutive points of one frame, 4 words per point, on a little-endian host
+///	\param in: first byte of the first point
+///	\param numPoints: # of points
+///	\param isInteger: words are 16-bit integers scaled by pointScale, floats otherwise
+///	\param encoding: Pt_Intel, Pt_Dec (VAX floats) or Pt_Mips (big-endian)
+///	\param pointScale: absolute value of POINT:SCALE
+///	\param positions: numPoints * 3 floats, x y z of each point
+///	\param residuals: numPoints floats or NULL, -1 for invalid points
+///
+void decodePoints(const unsigned char * in, uint numPoints, bool isInteger, UuIcsC3d::EncodingType encoding, float pointScale, float * positions, float * residuals);
+
+///
+/// \brief decode consecutive words to native floats without scaling, e.g. analog samples
+///	\param in: first byte of the first word
+///	\param numWords: # of words
+///	\param isInteger: words are 16-bit integers, floats otherwise
+///	\param encoding: Pt_Intel, Pt_Dec (VAX floats) or Pt_Mips (big-endian)
+///	\param out: numWords floats
+///
+void decodeWords(const unsigned char * in, uint numWords, bool isInteger, UuIcsC3d::EncodingType encoding, float * out);
+
+};
+
+#endif
\ No newline at end of file
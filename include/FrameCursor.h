@@ -0,0 +1,108 @@
+///
+/// \file FrameCursor.h
+/// \brief Frame by frame reading of a c3d file
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef FRAMECURSOR_H
+#define FRAMECURSOR_H
+
+#include <string>
+#include <memory>
+
+#include "Settings.h"
+#include "MarkerData.h"
+#include "uuc3d.hpp"
+
+namespace C3D
+{
+///
+/// \class FrameCursor
+/// \brief Pull-based cursor over the frames of a c3d file.
+///
+/// Only the current frame is kept in memory; its FrameData is reused by
+/// every call to next() or seek(), so memory does not grow with the length
+/// of the capture.
+///
+class FrameCursor
+{
+	UuIcsC3d::C3dFileInfo							_fileInfo;		///< header and parameter section
+	std::unique_ptr<UuIcsC3d::C3dFile>				_file;			///< opened frame data
+	UuIcsC3d::FrameData								_frameData;		///< decode buffer of the current frame
+	uint											_firstFrame;	///< first frame of the range
+	uint											_lastFrame;		///< end of the range (exclusive)
+	uint											_frame;			///< current frame
+	bool											_loaded;		///< true if _frameData holds _frame
+
+public:
+	///
+	/// \brief Constructor over all frames
+	///	\param fileName: c3d file
+	///
+	FrameCursor(std::string fileName);
+
+	///
+	/// \brief Constructor over a range of frames
+	///	\param fileName: c3d file
+	///	\param firstFrame: first frame (0 based)
+	///	\param lastFrame: end of the range (exclusive)
+	///
+	FrameCursor(std::string fileName, uint firstFrame, uint lastFrame);
+
+	///
+	/// \brief restrict the cursor to a range of frames and rewind it
+	///	\param firstFrame: first frame (0 based)
+	///	\param lastFrame: end of the range (exclusive), clamped to the frame count
+	///
+	void setFrameRange(uint firstFrame, uint lastFrame);
+
+	///
+	/// \brief decode the next frame of the range
+	///	\return false if the end of the range is reached
+	///
+	bool next();
+
+	///
+	/// \brief decode a given frame of the range
+	///	\param frame: frame (0 based)
+	///	\return false if the frame is outside the range
+	///
+	bool seek(uint frame);
+
+	///
+	/// \brief get the current frame
+	///	\return frame index (0 based)
+	///
+	uint getFrame() const;
+
+	///
+	/// \brief get the number of frames in the file
+	///	\return # of frames
+	///
+	uint getFrameCount() const;
+
+	///
+	/// \brief get the decoded data of the current frame
+	///	\return frame data, valid until the next call to next() or seek()
+	///
+	const UuIcsC3d::FrameData & getFrameData() const;
+
+	///
+	/// \brief get the position of a marker in the current frame
+	///	\param marker: marker index
+	///	\return Position
+	///
+	Marker::Position getPosition(uint marker) const;
+
+	///
+	/// \brief checks if a marker is valid in the current frame
+	///	\param marker: marker index
+	///	\return true if valid
+	///
+	bool isValid(uint marker) const;
+};
+
+};
+
+#endif
\ No newline at end of file
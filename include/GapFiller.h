@@ -0,0 +1,114 @@
+///
+/// \file GapFiller.h
+/// \brief Filling of the gaps of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef GAPFILLER_H
+#define GAPFILLER_H
+
+#include <vector>
+#include <map>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "ValidityIndex.h"
+#include "MarkerLayout.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+const uint				GAP_MAX_LENGTH = 10;			///< default longest gap filled, in frames
+const uint				GAP_SPLINE_SUPPORT = 4;			///< valid frames used on each side of a gap by the spline
+
+enum GapFillMethod {GAP_FILL_LINEAR, GAP_FILL_SPLINE, GAP_FILL_RIGID_BODY};
+
+///
+/// \class GapFiller
+/// \brief Fills the short gaps of the markers, flagging the filled samples as generated.
+///
+/// GAP_FILL_LINEAR joins the valid frames around a gap by a line and
+/// GAP_FILL_SPLINE by a natural cubic spline through GAP_SPLINE_SUPPORT valid
+/// frames on each side. Both leave the gaps at the ends of a capture open.
+/// GAP_FILL_RIGID_BODY rebuilds a foot marker from the other markers of the
+/// foot, moved rigidly from the frames around the gap, and falls back to the
+/// spline when they are missing or the marker is not on a foot. Gaps longer
+/// than the maximum length, like Header::max_interpolation_gap, are left
+/// open. Filled samples are valid and Trajectory::isGenerated() tells them
+/// from the measured ones. Only measured frames are read, so the markers of
+/// a trajectory are filled concurrently.
+///
+class GapFiller
+{
+	MarkerLayout									_layout;		///< order of the markers in the trajectories
+	GapFillMethod									_method;		///< interpolation
+	uint											_maxGap;		///< longest gap filled, in frames
+	uint											_numThreads;	///< # of worker threads
+
+public:
+	///
+	/// \brief Constructor
+	///	\param method: interpolation
+	///	\param maxGap: longest gap filled, in frames, see MappedC3DFile::getMaxInterpolationGap()
+	///	\param layout: order of the markers, only used by GAP_FILL_RIGID_BODY
+	///	\param numThreads: # of worker threads, 0 for one per hardware thread
+	///
+	GapFiller(GapFillMethod method = GAP_FILL_SPLINE, uint maxGap = GAP_MAX_LENGTH, const MarkerLayout & layout = MarkerLayout(), uint numThreads = 0);
+
+	///
+	/// \brief fill the gaps of every marker of a trajectory, one marker per task
+	///	\param trajectory: marker data, filled in place
+	///	\return # of samples filled
+	///
+	uint fill(Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief fill many trajectories, one marker of one trajectory per task
+	///	\param trajectories: captures filled in place
+	///	\return # of samples filled
+	///
+	uint fillAll(std::map<SequenceKey, Marker::Trajectory> & trajectories) const;
+
+	///
+	/// \brief fill the gaps of one marker
+	///	\param trajectory: marker data, only the invalid samples of the marker are written
+	///	\param validity: index of the trajectory before filling
+	///	\param marker: marker index
+	///	\return # of samples filled
+	///
+	uint fillMarker(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, uint marker) const;
+
+private:
+	///
+	/// \brief fill a gap by a line between its neighbours
+	///	\param trajectory: marker data
+	///	\param marker: marker index
+	///	\param gap: invalid frames, with valid frames on both sides
+	///
+	void fillLinear(Marker::Trajectory & trajectory, uint marker, const Marker::FrameRun & gap) const;
+
+	///
+	/// \brief fill a gap by a natural cubic spline through the valid frames around it
+	///	\param trajectory: marker data
+	///	\param validity: index of the trajectory before filling
+	///	\param marker: marker index
+	///	\param gap: invalid frames, with valid frames on both sides
+	///
+	void fillSpline(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, uint marker, const Marker::FrameRun & gap) const;
+
+	///
+	/// \brief fill a gap of a foot marker from the other markers of the foot
+	///	\param trajectory: marker data
+	///	\param validity: index of the trajectory before filling
+	///	\param foot: LEFT_FOOT or RIGHT_FOOT
+	///	\param element: FootMarkers index of the marker
+	///	\param gap: invalid frames
+	///	\return false if the other markers do not cover the gap and a frame next to it
+	///
+	bool fillRigidBody(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, BodyParts foot, uint element, const Marker::FrameRun & gap) const;
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+///
+/// \file HeaderTemplateCache.h
+/// \brief Process-wide cache of c3d header templates
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef HEADERTEMPLATECACHE_H
+#define HEADERTEMPLATECACHE_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Settings.h"
+#include "uuc3d.hpp"
+
+namespace C3D
+{
+///
+/// \class HeaderTemplateCache
+/// \brief Parses each template file once and shares the result between readers.
+///
+/// Templates are immutable once built, so the returned pointers can be used
+/// from any thread without locking. A template that cannot be opened is
+/// reported once and remembered as missing.
+///
+class HeaderTemplateCache
+{
+	typedef std::pair<std::string, uint> TemplateKey;		///< template path and # of markers
+
+	static std::mutex													_lock;			///< guards the map
+	static std::map<TemplateKey, std::shared_ptr<const UuIcsC3d::C3dFileInfo> >	_templates;		///< templates built so far, NULL if missing
+
+public:
+	///
+	/// \brief get the header template of a file, built on first use
+	///	\param fileName: c3d file whose header and parameter section are copied
+	///	\param numMarkers: # of points per frame, the template is adapted if the file has another count
+	///	\return template, NULL if the file cannot be opened
+	///
+	static std::shared_ptr<const UuIcsC3d::C3dFileInfo> get(std::string fileName, uint numMarkers);
+
+private:
+	///
+	/// \brief parse a template file
+	///	\param fileName: c3d file
+	///	\param numMarkers: # of points per frame
+	///	\return template, NULL if the file cannot be opened
+	///
+	static std::shared_ptr<const UuIcsC3d::C3dFileInfo> build(std::string fileName, uint numMarkers);
+};
+
+};
+
+#endif
\ No newline at end of file
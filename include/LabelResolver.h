@@ -0,0 +1,124 @@
+///
+/// \file LabelResolver.h
+/// \brief Resolution of point labels to the markers of the body parts
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef LABELRESOLVER_H
+#define LABELRESOLVER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Settings.h"
+#include "MarkerLayout.h"
+#include "Trajectory.h"
+
+namespace C3D
+{
+///
+/// \class MarkerIndex
+/// \brief Point index of every marker of a layout in one label set.
+///
+/// Built once per label set, after which a marker is found with one array
+/// lookup.
+///
+class MarkerIndex
+{
+	std::string										_subjectName;	///< label prefix of the subject
+	std::vector<uint>								_points;		///< point index of each layout marker, NO_MARKER if missing
+	uint											_groupStart[NUM_BODY_PARTS + 1];	///< first marker of each body part, then the # of markers
+
+public:
+	///
+	/// \brief Constructor, every marker missing
+	///	\param layout: markers to index
+	///
+	MarkerIndex(const MarkerLayout & layout);
+
+	///
+	/// \brief get the point index of a marker
+	///	\param part: body part
+	///	\param element: FootMarkers or PelvisMarkers value
+	///	\return point index, Marker::NO_MARKER if the label is missing
+	///
+	uint getPoint(BodyParts part, uint element) const { return _points[_groupStart[part] + element]; }
+
+	///
+	/// \brief get the point indices of a body part
+	///	\param part: body part
+	///	\return point indices in FootMarkers or PelvisMarkers order
+	///
+	std::vector<uint> getPoints(BodyParts part) const;
+
+	///
+	/// \brief get the point indices of every marker of the layout
+	///	\return point indices in layout order
+	///
+	const std::vector<uint> & getAllPoints() const;
+
+	///
+	/// \brief checks if every marker of the layout was found
+	///	\return true if complete
+	///
+	bool isComplete() const;
+
+	///
+	/// \brief get the subject whose labels were used
+	///	\return label prefix
+	///
+	std::string getSubjectName() const;
+
+	///
+	/// \brief set the point index of a marker
+	///	\param marker: marker index in the layout
+	///	\param point: point index
+	///
+	void setPoint(uint marker, uint point);
+
+	///
+	/// \brief set the subject whose labels were used
+	///	\param subjectName: label prefix
+	///
+	void setSubjectName(std::string subjectName);
+};
+
+///
+/// \class LabelResolver
+/// \brief Resolves point labels through UuIcsC3d::fill_skeletons, once per label set.
+///
+/// Captures of a dataset share a few label sets, so the index is cached by
+/// the labels and the layout names; the returned indices are immutable and
+/// can be shared between threads.
+///
+class LabelResolver
+{
+	static std::mutex													_lock;			///< guards the map
+	static std::map<std::string, std::shared_ptr<const MarkerIndex> >	_indices;		///< indices by signature
+
+public:
+	///
+	/// \brief get the index of a label set, resolved on first use
+	///	\param pointLabels: labels of all points of a file
+	///	\param layout: markers to find
+	///	\return index, incomplete if some markers are missing
+	///
+	static std::shared_ptr<const MarkerIndex> resolve(const std::vector<std::string> & pointLabels, const MarkerLayout & layout = MarkerLayout());
+
+private:
+	///
+	/// \brief match the labels to the layout
+	///	\param pointLabels: labels of all points of a file
+	///	\param layout: markers to find
+	///	\return index of the subject with the most markers found
+	///
+	static std::shared_ptr<const MarkerIndex> build(const std::vector<std::string> & pointLabels, const MarkerLayout & layout);
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+///
+/// \file MappedC3DFile.h
+/// \brief Memory-mapped access to the frame data of a c3d file
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef MAPPEDC3DFILE_H
+#define MAPPEDC3DFILE_H
+
+#include <string>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Settings.h"
+#include "AnalogData.h"
+#include "uuc3d.hpp"
+#include "basic_io.hpp"
+
+namespace C3D
+{
+///
+/// \class MappedC3DFile
+/// \brief Decodes points of a c3d file directly from a read-only mapping.
+///
+/// The header and parameter section are parsed once by UuIcsC3d::C3dFileInfo;
+/// the frames are then located through its FileInfo1 layout, so no FrameData
+/// is built per frame. Runs of consecutive points are converted in bulk by
+/// decodePoints.
+///
+class MappedC3DFile
+{
+	UuIcsC3d::C3dFileInfo							_fileInfo;		///< header and parameter section
+	boost::interprocess::file_mapping				_mapping;		///< mapping of the file
+	boost::interprocess::mapped_region				_region;		///< mapped view of the whole file
+	const unsigned char *							_frames;		///< first byte of frame 0, NULL if not mapped
+	UuIcsC3d::EncodingType							_encoding;		///< encoding of the frame words
+	uint											_frameCount;	///< # of complete frames in the mapping
+	uint											_numPoints;		///< # of points per frame
+	uint											_frameSize;		///< size of one frame in bytes
+	float											_pointScale;	///< scale of integer coordinates
+	bool											_isInteger;		///< coordinates stored as 16-bit integers
+	uint											_analogChannels;///< # of analog channels
+	uint											_analogSamples;	///< analog samples per frame
+	std::vector<float>								_analogScales;	///< SCALE * GEN_SCALE of each channel
+	std::vector<float>								_analogOffsets;	///< OFFSET of each channel
+
+public:
+	///
+	/// \brief Constructor, maps the file read-only
+	///	\param fileName: c3d file
+	///
+	MappedC3DFile(std::string fileName);
+
+	///
+	/// \brief checks if the frame data could be mapped
+	///	\return true if frames can be read
+	///
+	bool isOpen() const;
+
+	///
+	/// \brief get the header and parameter section
+	///	\return file info
+	///
+	const UuIcsC3d::C3dFileInfo & getFileInfo() const;
+
+	///
+	/// \brief get the number of frames
+	///	\return # of frames
+	///
+	uint getFrameCount() const;
+
+	///
+	/// \brief get the frame rate from the header
+	///	\return frames per second, 0 if the file is not open
+	///
+	float getFrameRate() const;
+
+	///
+	/// \brief get the longest gap the capture software was allowed to interpolate, from the header
+	///	\return # of frames, 0 if the file is not open
+	///
+	uint getMaxInterpolationGap() const;
+
+	///
+	/// \brief get the number of points per frame
+	///	\return # of points
+	///
+	uint getNumPoints() const;
+
+	///
+	/// \brief get the labels of the points
+	///	\return one label per point without padding, empty if the file has none
+	///
+	std::vector<std::string> getPointLabels() const;
+
+	///
+	/// \brief get the index of a point from its label
+	///	\param label: point label without padding
+	///	\return point index, -1 if there is no such label
+	///
+	int getPointIndex(std::string label) const;
+
+	///
+	/// \brief decode the points of consecutive frames into caller-owned buffers
+	///	\param firstFrame: first frame (0 based)
+	///	\param numFrames: # of frames to decode
+	///	\param positions: numFrames * getNumPoints() * 3 floats, x y z of each point, frame after frame
+	///	\param residuals: numFrames * getNumPoints() floats or NULL, -1 for invalid points
+	///	\return # of frames decoded
+	///
+	uint readPoints(uint firstFrame, uint numFrames, float * positions, float * residuals) const;
+
+	///
+	/// \brief decode a subset of the points of consecutive frames, the others are skipped
+	///	\param firstFrame: first frame (0 based)
+	///	\param numFrames: # of frames to decode
+	///	\param points: indices of the points to decode, out of range indices give invalid points
+	///	\param positions: numFrames * points.size() * 3 floats, x y z of each selected point, frame after frame
+	///	\param residuals: numFrames * points.size() floats or NULL, -1 for invalid points
+	///	\return # of frames decoded
+	///
+	uint readPoints(uint firstFrame, uint numFrames, const std::vector<uint> & points, float * positions, float * residuals) const;
+
+	///
+	/// \brief get the labels of the analog channels
+	///	\return one label per channel without padding, empty if the file has none
+	///
+	std::vector<std::string> getAnalogLabels() const;
+
+	///
+	/// \brief decode the analog channels of consecutive frames in one pass
+	///	\param firstFrame: first frame (0 based)
+	///	\param numFrames: # of frames to decode
+	///	\param analog: resized to the # of channels and frames decoded, scaled values
+	///	\return # of frames decoded
+	///
+	uint readAnalog(uint firstFrame, uint numFrames, AnalogData & analog) const;
+
+	///
+	/// \brief get the number of analog channels from the frame layout, FileInfo1::analog_channels is not filled in by uuc3d
+	///	\param fileInfo: header and parameter section
+	///	\return # of channels
+	///
+	static uint getAnalogChannels(const UuIcsC3d::C3dFileInfo & fileInfo);
+
+	///
+	/// \brief get the values of a float or integer parameter
+	///	\param groupName: group, e.g. "ANALOG"
+	///	\param parameterName: parameter, e.g. "SCALE"
+	///	\return all values in storage order, empty if the parameter is missing or holds characters
+	///
+	std::vector<float> getParameterValues(std::string groupName, std::string parameterName) const;
+};
+
+};
+
+#endif
\ No newline at end of file
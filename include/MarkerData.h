@@ -9,7 +9,7 @@
 #define MARKER_H
 
 #include <iostream>
-#include <mutex>
+#include <string>
 
 namespace Marker
 {
@@ -27,27 +27,33 @@ struct Position
 ///
 /// \class MarkerData
 /// \brief data wrt one marker
+///
+/// A plain value without locking: it is filled while loading and only read
+/// afterwards. Sequences publish their data as a read-only Trajectory, see
+/// Sequence::getTrajectory().
+/// No time is stored per marker, the time of a frame is given by the
+/// Timeline of its trajectory.
 ///
 class MarkerData
 {
 private:
 	Position 				_position;	///< position of marker
-	std::string				_timestamp;	///< timestamp of recording
-	std::mutex 				_mutexLock;	///< lock
+	bool					_valid;		///< false if a coordinate is missing
 public:
 	///
-	/// \brief Constructor
+	/// \brief Constructor of an invalid marker
 	///
 	MarkerData();
 	///
-	/// \brief Copy Constructor
+	/// \brief Constructor
+	///	\param position: position of marker
 	///
-	MarkerData(const MarkerData &);
+	MarkerData(Position position);
 	///
 	/// \brief get the marker position
 	///	\return Position
 	///
-	Position getPosition();
+	Position getPosition() const { return _position; }
 	///
 	/// \brief set the marker position
 	///	\param pos: position of marker
@@ -72,22 +78,12 @@ public:
 	/// \brief checks if marker position is valid
 	///	\return true if valid
 	///
-	bool isValid();
-	///
-	/// \brief set the timestamp of marker data
-	///	\param timestamp: timestamp of recording
-	///
-	void setTimestamp(std::string timestamp);
-	///
-	/// \brief get the timestamp of marker data
-	///	\return timestamp
-	///
-	std::string getTimestamp();
+	bool isValid() const { return _valid; }
 	///
 	/// \brief get the marker data in the form of string
 	///	\return marker data in the form of string
 	///
-	std::string getString();
+	std::string getString() const;
 }; // End of class MarkerData
 
 }; // end of namespace Marker
@@ -0,0 +1,83 @@
+///
+/// \file MarkerLayout.h
+/// \brief Marker names of the body parts
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef MARKERLAYOUT_H
+#define MARKERLAYOUT_H
+
+#include <string>
+#include <vector>
+
+#include "Settings.h"
+#include "skeleton_info.hpp"
+
+namespace C3D
+{
+const uint				NUM_BODY_PARTS = 3;				///< left foot, right foot and pelvis
+const uint				NUM_FOOT_MARKERS = 4;			///< markers per foot, see FootMarkers
+const uint				NUM_PELVIS_MARKERS = 2;			///< markers on the pelvis, see PelvisMarkers
+
+///
+/// \class MarkerLayout
+/// \brief Names of the markers of each body part, as a skeleton for UuIcsC3d::fill_skeletons.
+///
+/// Groups follow BodyParts and the markers of a group follow FootMarkers or
+/// PelvisMarkers, so a marker is addressed by (body part, element) whatever
+/// the order of the labels in a c3d file.
+///
+class MarkerLayout : public UuIcsC3d::SkeletonInfo
+{
+	std::vector<std::string>						_names;			///< marker names, grouped by body part
+	uint											_groupStart[NUM_BODY_PARTS + 1];	///< first name of each body part, then the # of names
+
+public:
+	///
+	/// \brief Constructor with the default marker names
+	///
+	MarkerLayout();
+
+	///
+	/// \brief Constructor
+	///	\param leftFoot: NUM_FOOT_MARKERS names in FootMarkers order
+	///	\param rightFoot: NUM_FOOT_MARKERS names in FootMarkers order
+	///	\param pelvis: NUM_PELVIS_MARKERS names in PelvisMarkers order
+	///
+	MarkerLayout(std::vector<std::string> leftFoot, std::vector<std::string> rightFoot, std::vector<std::string> pelvis);
+
+	///
+	/// \brief get the position of a marker in the layout
+	///	\param part: body part
+	///	\param element: FootMarkers or PelvisMarkers value
+	///	\return index in [0, getNumMarkers())
+	///
+	uint getIndex(BodyParts part, uint element) const { return _groupStart[part] + element; }
+
+	///
+	/// \brief get the number of markers of the layout
+	///	\return # of markers
+	///
+	uint getNumMarkers() const { return _names.size(); }
+
+	///
+	/// \brief get a string identifying the marker names
+	///	\return names joined by newlines
+	///
+	std::string getSignature() const;
+
+	// UuIcsC3d::SkeletonInfo
+	std::string const * begin() const;
+	std::string const * end() const;
+	int group_count() const;
+	std::string group_name(int g) const;
+	UuIcsC3d::ConstNameRange group_members(int g) const;
+	std::vector<int> group_connections(int g) const;
+	GrEl to_grel(int label_no) const;
+	int to_label_no(GrEl const & grel) const;
+};
+
+};
+
+#endif
\ No newline at end of file
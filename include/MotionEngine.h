@@ -0,0 +1,111 @@
+///
+/// \file MotionEngine.h
+/// \brief Speed and rotation speed of the feet and the pelvis
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef MOTIONENGINE_H
+#define MOTIONENGINE_H
+
+#include <vector>
+#include <map>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "MarkerLayout.h"
+#include "OrientationKernels.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+const uint				MOTION_BLOCK_FRAMES = 1024;		///< frames derived per pass, the scratch of a block stays in L1
+
+///
+/// \struct PartMotion
+/// \brief Motion of one body part, one value per frame, NaN where a marker of the part is invalid
+///
+/// Units are per frame, as in Subject::Thresholds.
+///
+struct PartMotion
+{
+	std::vector<float>		speed;				///< speed of the centroid of the markers in mm per frame
+	std::vector<float>		orientation;		///< orientation wrt x-axis, see OrientationKernels.h
+	std::vector<float>		rotSpeed;			///< absolute rotation speed in radians per frame, across the wrap-around
+};
+
+///
+/// \struct SequenceMotion
+/// \brief Motion of every body part of one capture
+///
+struct SequenceMotion
+{
+	PartMotion				parts[NUM_BODY_PARTS];	///< indexed by BodyParts
+	Marker::Timeline		timeline;				///< time of the frames
+};
+
+///
+/// \class MotionEngine
+/// \brief Derives the speed and rotation speed of the feet and the pelvis from columnar marker data.
+///
+/// Centroids, orientations and central differences of a block of frames
+/// are computed in one pass over the columns. A difference falls back to a
+/// one-sided one next to an invalid frame or the ends of the capture, and
+/// orientation differences are wrapped to [-PI, PI] before halving.
+///
+class MotionEngine
+{
+	MarkerLayout									_layout;		///< order of the markers in the trajectories
+	OrientationMode									_mode;			///< arctangent of the orientations
+	uint											_numThreads;	///< # of worker threads of computeAll
+
+public:
+	///
+	/// \brief Constructor
+	///	\param layout: trajectories are read with C3DReader::setMarkerSubset(layout)
+	///	\param mode: exact or fast arctangent
+	///	\param numThreads: # of worker threads of computeAll, 0 for one per hardware thread
+	///
+	MotionEngine(const MarkerLayout & layout = MarkerLayout(), OrientationMode mode = ORIENTATION_FAST, uint numThreads = 0);
+
+	///
+	/// \brief derive the motion of every body part of a capture
+	///	\param trajectory: markers in layout order
+	///	\param motion: one value per frame of the trajectory
+	///
+	void compute(const Marker::Trajectory & trajectory, SequenceMotion & motion) const;
+
+	///
+	/// \brief derive the motion of many captures concurrently
+	///	\param trajectories: markers in layout order
+	///	\return motion of each capture
+	///
+	std::map<SequenceKey, SequenceMotion> computeAll(const std::map<SequenceKey, Marker::Trajectory> & trajectories) const;
+
+	///
+	/// \brief derive the motion of one body part
+	///	\param trajectory: marker data
+	///	\param markers: marker indices whose centroid moves
+	///	\param fromMarker: tail of the orientation vector
+	///	\param toMarker: head of the orientation vector
+	///	\param offset: added to the orientations
+	///	\param motion: one value per frame of the trajectory
+	///
+	void computePart(const Marker::Trajectory & trajectory, const std::vector<uint> & markers, uint fromMarker, uint toMarker, double offset, PartMotion & motion) const;
+
+	///
+	/// \brief derive consecutive frames of a centroid and an orientation, the same values whatever the # of frames
+	///	\param x: centroid x, read from one frame before the first to one frame after the last, NaN if invalid
+	///	\param y: centroid y, same frames
+	///	\param z: centroid z, same frames
+	///	\param orientation: orientation, same frames
+	///	\param count: # of frames
+	///	\param speed: count speeds in mm per frame
+	///	\param rotSpeed: count rotation speeds in radians per frame
+	///
+	static void derive(const float * x, const float * y, const float * z, const float * orientation, uint count, float * speed, float * rotSpeed);
+};
+
+};
+
+#endif
\ No newline at end of file
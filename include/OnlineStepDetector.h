@@ -0,0 +1,113 @@
+///
+/// \file OnlineStepDetector.h
+/// \brief Step detection on a live stream of frames
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef ONLINESTEPDETECTOR_H
+#define ONLINESTEPDETECTOR_H
+
+#include <functional>
+
+#include "Settings.h"
+#include "StepDetector.h"
+
+namespace C3D
+{
+const uint				ONLINE_STEP_LATENCY = 1;		///< frames between a transition and its event, the central difference needs the next frame
+
+///
+/// \class OnlineStepDetector
+/// \brief Incremental StepDetector, fed one frame at a time with constant work and memory per frame.
+///
+/// The speeds of frame f are derived when frame f + 1 arrives, with the same
+/// kernels as MotionEngine, so events come ONLINE_STEP_LATENCY frames (about
+/// 2 ms at FRAME_RATE) after the frame they refer to. Every step closed by
+/// the stream is the step StepDetector::detect finds on the whole capture.
+///
+class OnlineStepDetector
+{
+	///
+	/// \struct FootFrame
+	/// \brief Data of one foot in one frame
+	///
+	struct FootFrame
+	{
+		Marker::Position		positions[NUM_FOOT_MARKERS];	///< markers in FootMarkers order
+		float					centroid[Marker::NUM_AXES];		///< centroid of the markers
+		float					orientation;					///< orientation wrt x-axis
+	};
+
+	///
+	/// \struct FootState
+	/// \brief Last frames and step state of one foot
+	///
+	struct FootState
+	{
+		FootFrame				frames[3];						///< frames f - 1, f and f + 1 around the frame to derive
+		FootFrame				start;							///< first frame of the open step
+		StepTracker				tracker;						///< hysteresis state
+	};
+
+	Subject::Thresholds								_thresholds;	///< thresholds of the subject
+	MarkerLayout									_layout;		///< order of the markers in the frames
+	std::function<void(StepEvent, const Step &)>	_listener;		///< receives the events
+	FootState										_feet[2];		///< LEFT_FOOT and RIGHT_FOOT
+	uint											_numFrames;		///< # of frames fed
+
+public:
+	///
+	/// \brief Constructor
+	///	\param listener: called on the calling thread for every STEP_STARTED, STEP_ENDED and STEP_DISCARDED, only the frames and foot of the step are set before STEP_ENDED
+	///	\param thresholds: thresholds of the subject
+	///	\param layout: order of the markers in the frames
+	///
+	OnlineStepDetector(std::function<void(StepEvent, const Step &)> listener, const Subject::Thresholds & thresholds = Subject::Thresholds(), const MarkerLayout & layout = MarkerLayout());
+
+	///
+	/// \brief feed the next frame
+	///	\param positions: layout.getNumMarkers() positions in layout order, NaN if invalid
+	///
+	void update(const Marker::Position * positions);
+
+	///
+	/// \brief feed a batch of frames
+	///	\param trajectory: markers in layout order
+	///
+	void update(const Marker::Trajectory & trajectory);
+
+	///
+	/// \brief derive the last frame at the end of the stream, as the last frame of a capture, reset() before the next stream
+	///
+	void flush();
+
+	///
+	/// \brief start a new stream, an open step is dropped
+	///
+	void reset();
+
+	///
+	/// \brief get the number of frames fed since the last reset
+	///	\return # of frames
+	///
+	uint getNumFrames() const;
+
+private:
+	///
+	/// \brief set every value of a frame to NaN
+	///	\param frame: frame data
+	///
+	static void clearFrame(FootFrame & frame);
+
+	///
+	/// \brief derive the middle frame of a foot and feed it to its tracker
+	///	\param foot: LEFT_FOOT or RIGHT_FOOT
+	///	\param frame: index of the middle frame
+	///
+	void step(BodyParts foot, uint frame);
+};
+
+};
+
+#endif
\ No newline at end of file
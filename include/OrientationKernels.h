@@ -0,0 +1,93 @@
+///
+/// \file OrientationKernels.h
+/// \brief Foot and pelvis orientation of every frame of a trajectory
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef ORIENTATIONKERNELS_H
+#define ORIENTATIONKERNELS_H
+
+#include <vector>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "LabelResolver.h"
+
+namespace C3D
+{
+const float				FAST_ATAN2_MAX_ERROR = 2e-5f;	///< bound on the error of fastAtan2 in radians
+
+///
+/// \enum OrientationMode
+/// \brief Arctangent used by the orientation kernels
+///
+enum OrientationMode
+{
+	ORIENTATION_EXACT,		///< std::atan2, same values as Sequence::getFootOrientation and Sequence::getPelvisOrientation
+	ORIENTATION_FAST		///< polynomial arctangent, within FAST_ATAN2_MAX_ERROR, vectorised
+};
+
+///
+/// \brief polynomial approximation of std::atan2, NaN if a coordinate is NaN
+///	\param y: y coordinate
+///	\param x: x coordinate
+///	\return angle in [-PI, PI], within FAST_ATAN2_MAX_ERROR
+///
+float fastAtan2(float y, float x);
+
+///
+/// \brief orientation of the vector between two markers over consecutive frames
+///	\param fromX: x column of the first marker
+///	\param fromY: y column of the first marker
+///	\param toX: x column of the second marker
+///	\param toY: y column of the second marker
+///	\param numFrames: # of frames
+///	\param offset: added to every angle
+///	\param mode: exact or fast arctangent
+///	\param orientations: numFrames angles, NaN where a marker is invalid
+///
+void computeOrientations(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, double offset, OrientationMode mode, float * orientations);
+
+///
+/// \brief orientation of a foot wrt x-axis over all frames, see Sequence::getFootOrientation
+///	\param trajectory: marker data
+///	\param topMarker: marker index of FOOT_TOP
+///	\param bottomMarker: marker index of FOOT_BOTTOM
+///	\param mode: exact or fast arctangent
+///	\return one angle in [-PI, PI] per frame, NaN where a marker is invalid or missing
+///
+std::vector<float> getFootOrientations(const Marker::Trajectory & trajectory, uint topMarker, uint bottomMarker, OrientationMode mode = ORIENTATION_FAST);
+
+///
+/// \brief orientation of a foot wrt x-axis over all frames, markers found through an index
+///	\param trajectory: marker data, read with the points of the index
+///	\param index: point index of the layout markers
+///	\param foot: LEFT_FOOT or RIGHT_FOOT
+///	\param mode: exact or fast arctangent
+///	\return one angle in [-PI, PI] per frame, NaN where a marker is invalid or missing
+///
+std::vector<float> getFootOrientations(const Marker::Trajectory & trajectory, const MarkerIndex & index, BodyParts foot, OrientationMode mode = ORIENTATION_FAST);
+
+///
+/// \brief orientation of the pelvis wrt x-axis over all frames, see Sequence::getPelvisOrientation
+///	\param trajectory: marker data
+///	\param leftMarker: marker index of PELVIS_LEFT
+///	\param rightMarker: marker index of PELVIS_RIGHT
+///	\param mode: exact or fast arctangent
+///	\return one angle in [0, 2 PI] per frame, NaN where a marker is invalid or missing
+///
+std::vector<float> getPelvisOrientations(const Marker::Trajectory & trajectory, uint leftMarker, uint rightMarker, OrientationMode mode = ORIENTATION_FAST);
+
+///
+/// \brief orientation of the pelvis wrt x-axis over all frames, markers found through an index
+///	\param trajectory: marker data, read with the points of the index
+///	\param index: point index of the layout markers
+///	\param mode: exact or fast arctangent
+///	\return one angle in [0, 2 PI] per frame, NaN where a marker is invalid or missing
+///
+std::vector<float> getPelvisOrientations(const Marker::Trajectory & trajectory, const MarkerIndex & index, OrientationMode mode = ORIENTATION_FAST);
+
+};
+
+#endif
\ No newline at end of file
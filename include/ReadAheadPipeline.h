@@ -0,0 +1,113 @@
+///
+/// \file ReadAheadPipeline.h
+/// \brief Background reading of the next c3d files of a batch
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef READAHEADPIPELINE_H
+#define READAHEADPIPELINE_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include "Settings.h"
+#include "C3DReader.h"
+#include "DatasetLoader.h"
+#include "ThreadPool.h"
+
+namespace C3D
+{
+///
+/// \class ReadAheadPipeline
+/// \brief Reads the captures of a batch on background threads while the caller processes the previous ones.
+///
+/// At most depth files are being read or waiting to be consumed; the read of
+/// the next file starts only when the caller takes one, so memory stays
+/// bounded whatever the speed of the caller. Captures are delivered in the
+/// order of the keys.
+///
+class ReadAheadPipeline
+{
+	///
+	/// \struct Slot
+	/// \brief One capture being read or waiting to be consumed
+	///
+	struct Slot
+	{
+		LoadTiming				timing;			///< capture and its read time
+		Marker::Trajectory		trajectory;		///< trajectory once read
+		bool					ready;			///< set by the reading thread
+
+		Slot(SequenceKey key) :
+			timing(key, DatasetLoader::getFileName(key)),
+			ready(false)
+		{
+		}
+	};
+
+	C3DReader										_reader;		///< copy of the reader, holds the marker subset
+	std::vector<SequenceKey>						_keys;			///< captures of the batch
+	uint											_nextKey;		///< first key not submitted yet
+	std::deque<std::shared_ptr<Slot> >				_slots;			///< submitted captures, in key order
+	std::vector<LoadTiming>							_timings;		///< timings of the captures consumed
+	double											_waitSeconds;	///< time the caller spent waiting for reads
+	bool											_cancelled;		///< set by the destructor, skips pending reads
+	std::mutex										_mutex;			///< protects the slots and _cancelled
+	std::condition_variable							_slotReady;		///< signalled when a read completes
+	ThreadPool										_pool;			///< reading threads, destroyed first
+
+public:
+	///
+	/// \brief Constructor, starts reading the first captures
+	///	\param reader: reader to copy, e.g. with a marker subset
+	///	\param keys: captures to read, in delivery order
+	///	\param depth: max # of captures read ahead of the caller, at least 1
+	///	\param numThreads: # of reading threads, 0 for depth or the # of hardware threads if fewer
+	///
+	ReadAheadPipeline(const C3DReader & reader, std::vector<SequenceKey> keys, uint depth = 2, uint numThreads = 0);
+
+	///
+	/// \brief Destructor, drops the captures not consumed and waits for the reads in progress
+	///
+	~ReadAheadPipeline();
+
+	///
+	/// \brief take the next capture, blocks until it has been read; captures that cannot be read are skipped
+	///	\param key: capture
+	///	\param trajectory: trajectory of the capture
+	///	\return false once every capture has been delivered
+	///
+	bool next(SequenceKey & key, Marker::Trajectory & trajectory);
+
+	///
+	/// \brief get the timings of the captures taken so far, including the ones skipped
+	///	\return timings in key order
+	///
+	const std::vector<LoadTiming> & getTimings() const;
+
+	///
+	/// \brief get the time next() spent waiting for reads, close to 0 when reading keeps ahead of processing
+	///	\return seconds
+	///
+	double getWaitSeconds() const;
+
+private:
+	///
+	/// \brief queue the read of the next key
+	///
+	void submitNext();
+
+	///
+	/// \brief read one capture, run on a pool thread
+	///	\param slot: capture to read
+	///
+	void read(std::shared_ptr<Slot> slot);
+};
+
+};
+
+#endif
\ No newline at end of file
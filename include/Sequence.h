@@ -10,8 +10,10 @@
 
 #include "Settings.h"
 #include "MarkerData.h"
+#include "Trajectory.h"
 
 #include <vector>
+#include <memory>
 
 using namespace std;
 
@@ -19,10 +21,15 @@ using namespace std;
 /// \class Sequence
 /// \brief Sequence Class
 ///
+/// The marker data is published as an immutable snapshot: readers take a
+/// reference with getTrajectory() and keep it for as long as they need,
+/// while a reload swaps in a new snapshot without locking the readers out.
+///
 class Sequence
 {
 private:
-	uint				_sequenceNumber; 			///< sequence number
+	uint									_sequenceNumber; 			///< sequence number
+	shared_ptr<const Marker::Trajectory>	_trajectory;				///< published marker data, NULL until loaded
 	
 public:
 	///
@@ -31,19 +38,31 @@ public:
 	///
 	Sequence(uint sequenceNumber);
 
+	///
+	/// \brief get the published marker data, safe to call from any thread
+	/// \return read-only trajectory, NULL if not loaded
+	///
+	shared_ptr<const Marker::Trajectory> getTrajectory() const;
+
+	///
+	/// \brief publish new marker data, readers holding the previous one keep it
+	/// \param trajectory: marker data, not modified afterwards
+	///
+	void setTrajectory(shared_ptr<const Marker::Trajectory> trajectory);
+
 	///
 	/// \brief get orientation from foot markers
 	/// \param markers: marker data
 	/// \return orientation wrt x-axis
 	///
-	static float getFootOrientation(vector<Marker::MarkerData> markers);
+	static float getFootOrientation(const vector<Marker::MarkerData> & markers);
 
 	///
 	/// \brief get orientation from pelvis markers
 	/// \param markers: marker data
 	/// \return orientation wrt x-axis
 	///
-	static float getPelvisOrientation(vector<Marker::MarkerData> markers);
+	static float getPelvisOrientation(const vector<Marker::MarkerData> & markers);
 
 private:
 };
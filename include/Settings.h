@@ -29,5 +29,6 @@ const uint				NORMALISATION_HEIGHT = 1860;	///< height in mm
 enum BodyParts {LEFT_FOOT, RIGHT_FOOT, PELVIS};
 enum FootMarkers {FOOT_LEFT, FOOT_TOP, FOOT_RIGHT, FOOT_BOTTOM};
 enum PelvisMarkers {PELVIS_LEFT, PELVIS_RIGHT};
+enum CalibrationSequences {CALIBRATION_BODY = NUM_SEQUENCES + 1, CALIBRATION_LEFT, CALIBRATION_RIGHT};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+///
+/// \file StepDetector.h
+/// \brief Segmentation of the foot motion into steps
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef STEPDETECTOR_H
+#define STEPDETECTOR_H
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+#include "Settings.h"
+#include "Subject.h"
+#include "Trajectory.h"
+#include "MarkerLayout.h"
+#include "MotionEngine.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+const float				STEP_RELEASE_RATIO = 0.5f;		///< a step ends once both speeds drop below this fraction of their thresholds
+
+enum StepEvent {STEP_NONE, STEP_STARTED, STEP_ENDED, STEP_DISCARDED};
+
+///
+/// \struct Step
+/// \brief One step of one foot
+///
+struct Step
+{
+	uint32_t		firstFrame;			///< first moving frame
+	uint32_t		lastFrame;			///< first frame at rest after the step, the step is [firstFrame, lastFrame)
+	BodyParts		foot;				///< LEFT_FOOT or RIGHT_FOOT
+	float			displacementX;		///< x displacement of the centroid of the foot markers in mm
+	float			displacementY;		///< y displacement of the centroid of the foot markers in mm
+	float			rotation;			///< change of the foot orientation in [-PI, PI]
+};
+
+///
+/// \class StepTracker
+/// \brief Hysteresis state machine of one foot, fed one frame at a time.
+///
+/// A step starts on the first frame whose speed or rotation speed exceeds
+/// its threshold, and ends on the first frame where both are below
+/// STEP_RELEASE_RATIO times their thresholds. Steps shorter than
+/// stepSizeThreshold frames are discarded. Invalid frames and frames above
+/// a cutoff are glitches and leave the state unchanged.
+///
+class StepTracker
+{
+	Subject::Thresholds								_thresholds;	///< thresholds of the subject
+	bool											_moving;		///< true inside a step
+	uint											_frame;			///< # of frames fed
+	uint											_firstFrame;	///< first frame of the current or last step
+	uint											_lastFrame;		///< end of the last step
+
+public:
+	///
+	/// \brief Constructor
+	///	\param thresholds: thresholds of the subject
+	///
+	StepTracker(const Subject::Thresholds & thresholds = Subject::Thresholds());
+
+	///
+	/// \brief feed the next frame
+	///	\param speed: speed of the foot in mm per frame, NaN if invalid
+	///	\param rotSpeed: rotation speed of the foot in radians per frame, NaN if invalid
+	///	\return STEP_STARTED or STEP_ENDED on a transition, STEP_DISCARDED if the step was too short
+	///
+	StepEvent update(float speed, float rotSpeed)
+	{
+		uint frame = _frame++;
+		if(!(speed <= _thresholds.speedCutoff) || !(rotSpeed <= _thresholds.rotSpeedCutoff))
+			return STEP_NONE;
+		if(!_moving)
+		{
+			if(speed <= _thresholds.speedThreshold && rotSpeed <= _thresholds.rotSpeedThreshold)
+				return STEP_NONE;
+			_moving = true;
+			_firstFrame = frame;
+			return STEP_STARTED;
+		}
+		if(speed >= _thresholds.speedThreshold * STEP_RELEASE_RATIO || rotSpeed >= _thresholds.rotSpeedThreshold * STEP_RELEASE_RATIO)
+			return STEP_NONE;
+		_moving = false;
+		_lastFrame = frame;
+		return frame - _firstFrame >= _thresholds.stepSizeThreshold ? STEP_ENDED : STEP_DISCARDED;
+	}
+
+	///
+	/// \brief restart at frame 0, at rest
+	///
+	void reset();
+
+	///
+	/// \brief checks if the foot is inside a step
+	///	\return true if moving
+	///
+	bool isMoving() const { return _moving; }
+
+	///
+	/// \brief get the number of frames fed
+	///	\return # of frames
+	///
+	uint getNumFrames() const { return _frame; }
+
+	///
+	/// \brief get the first frame of the current step, or of the last one at rest
+	///	\return frame index
+	///
+	uint getFirstFrame() const { return _firstFrame; }
+
+	///
+	/// \brief get the end of the last step
+	///	\return first frame at rest
+	///
+	uint getLastFrame() const { return _lastFrame; }
+};
+
+///
+/// \class StepDetector
+/// \brief Segments the motion of both feet of whole captures into steps.
+///
+/// Each foot is one pass of a StepTracker over the speeds of MotionEngine.
+/// A step still open at the end of a capture is dropped.
+///
+class StepDetector
+{
+	Subject::Thresholds								_thresholds;	///< thresholds of the subject
+	MarkerLayout									_layout;		///< order of the markers in the trajectories
+	MotionEngine									_engine;		///< speeds of the feet
+	uint											_numThreads;	///< # of worker threads of detectAll
+
+public:
+	///
+	/// \brief Constructor
+	///	\param thresholds: thresholds of the subject
+	///	\param layout: trajectories are read with C3DReader::setMarkerSubset(layout)
+	///	\param numThreads: # of worker threads of detectAll, 0 for one per hardware thread
+	///
+	StepDetector(const Subject::Thresholds & thresholds = Subject::Thresholds(), const MarkerLayout & layout = MarkerLayout(), uint numThreads = 0);
+
+	///
+	/// \brief detect the steps of both feet of a capture
+	///	\param trajectory: markers in layout order
+	///	\return steps ordered by first frame, then foot
+	///
+	std::vector<Step> detect(const Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief detect the steps of one foot from its motion
+	///	\param trajectory: markers in layout order
+	///	\param motion: motion of the foot, see MotionEngine
+	///	\param foot: LEFT_FOOT or RIGHT_FOOT
+	///	\param steps: steps of the foot, appended
+	///
+	void detectFoot(const Marker::Trajectory & trajectory, const PartMotion & motion, BodyParts foot, std::vector<Step> & steps) const;
+
+	///
+	/// \brief detect the steps of many captures concurrently
+	///	\param trajectories: markers in layout order
+	///	\return steps of each capture
+	///
+	std::map<SequenceKey, std::vector<Step> > detectAll(const std::map<SequenceKey, Marker::Trajectory> & trajectories) const;
+
+	///
+	/// \brief load every capture of a subject and detect its steps
+	///	\param loader: loader, its marker subset is set to the layout
+	///	\param subjectNumber: subject #
+	///	\return steps of each capture that could be read
+	///
+	std::map<SequenceKey, std::vector<Step> > detectSubject(DatasetLoader & loader, uint subjectNumber) const;
+
+	///
+	/// \brief make the step record of a closed step
+	///	\param foot: LEFT_FOOT or RIGHT_FOOT
+	///	\param firstFrame: first moving frame
+	///	\param lastFrame: first frame at rest
+	///	\param firstPositions: NUM_FOOT_MARKERS positions of the foot at firstFrame, in FootMarkers order
+	///	\param lastPositions: NUM_FOOT_MARKERS positions of the foot at lastFrame
+	///	\param firstOrientation: orientation of the foot at firstFrame
+	///	\param lastOrientation: orientation of the foot at lastFrame
+	///	\return step
+	///
+	static Step makeStep(BodyParts foot, uint firstFrame, uint lastFrame, const Marker::Position * firstPositions, const Marker::Position * lastPositions, float firstOrientation, float lastOrientation);
+};
+
+};
+
+#endif
\ No newline at end of file
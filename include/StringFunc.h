@@ -14,6 +14,8 @@ using namespace std;
 
 #include <sstream>
 
+const unsigned int FLOAT_CHARS = 24;		///< max # of characters written by floatToChars
+
 ///
 /// \brief string to integer
 /// \param input string
@@ -35,4 +37,19 @@ unsigned int stringToUInt(string input);
 ///
 string intToString(int input);
 
+///
+/// \brief float to the shortest decimal that reads back as the same float
+/// \param input float, NaN is written as "NaN"
+/// \param output at least FLOAT_CHARS characters, not null terminated
+/// \return end of the characters written
+///
+char * floatToChars(float input, char * output);
+
+///
+/// \brief float to the shortest decimal that reads back as the same float
+/// \param input float
+/// \return string
+///
+string floatToString(float input);
+
 #endif
\ No newline at end of file
@@ -19,6 +19,7 @@ using namespace std;
 ///
 class Subject
 {
+public:
 	///
 	/// \struct Thresholds for the subject
 	/// 
@@ -40,6 +41,7 @@ class Subject
 		}
 	};
 
+private:
 	///
 	/// \struct Calibration Correction
 	/// 
@@ -84,6 +86,12 @@ public:
 	///
 	void setThresholds(Thresholds thresholds);
 
+	///
+	/// \brief get the thresholds for the subject
+	/// \return thresholds to determine the steps
+	///
+	Thresholds getThresholds() const;
+
 	///
 	/// \brief read the calibration files and store the corrections
 	///
@@ -0,0 +1,82 @@
+///
+/// \file ThreadPool.h
+/// \brief Fixed-size pool of worker threads
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Settings.h"
+
+///
+/// \class ThreadPool
+/// \brief Runs tasks on a fixed set of threads with a bounded number of tasks in flight.
+///
+/// submit() blocks while maxInFlight tasks are queued or running, so a
+/// producer cannot get arbitrarily far ahead of the workers.
+///
+class ThreadPool
+{
+private:
+	std::vector<std::thread>				_workers;			///< worker threads
+	std::deque<std::function<void()> >		_tasks;				///< queued tasks
+	std::mutex								_mutex;				///< protects the queue and counters
+	std::condition_variable					_taskAvailable;		///< signalled when a task is queued
+	std::condition_variable					_slotAvailable;		///< signalled when a task completes
+	uint									_maxInFlight;		///< max # of queued and running tasks
+	uint									_inFlight;			///< # of queued and running tasks
+	bool									_stopping;			///< set by the destructor
+
+public:
+	///
+	/// \brief Constructor, starts the workers
+	/// \param numThreads: # of workers, 0 for one per hardware thread
+	/// \param maxInFlight: max # of queued and running tasks, 0 for twice the # of workers
+	///
+	ThreadPool(uint numThreads = 0, uint maxInFlight = 0);
+
+	///
+	/// \brief Destructor, finishes the queued tasks and joins the workers
+	///
+	~ThreadPool();
+
+	///
+	/// \brief queue a task, blocks while too many tasks are in flight
+	/// \param task: task to run, exceptions are reported and swallowed
+	///
+	void submit(std::function<void()> task);
+
+	///
+	/// \brief wait until every submitted task has completed
+	///
+	void wait();
+
+	///
+	/// \brief get the number of workers
+	/// \return # of threads
+	///
+	uint getNumThreads() const;
+
+	///
+	/// \brief get the number of hardware threads
+	/// \return # of threads, at least 1
+	///
+	static uint getHardwareThreads();
+
+private:
+	///
+	/// \brief loop run by every worker
+	///
+	void work();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+///
+/// \file Timeline.h
+/// \brief Mapping between frame indices and time
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "Settings.h"
+
+namespace Marker
+{
+///
+/// \class Timeline
+/// \brief Time of the frames of a trajectory.
+///
+/// Frames are sampled at a constant rate, so the time of a frame is
+/// arithmetic on its index and no time is stored per sample. Times are in
+/// seconds from the first frame of the c3d file.
+///
+class Timeline
+{
+private:
+	float					_frameRate;			///< frames per second
+	uint					_firstFrame;		///< frame of the c3d file stored as frame 0
+
+public:
+	///
+	/// \brief Constructor
+	///	\param frameRate: frames per second, FRAME_RATE if not positive
+	///	\param firstFrame: frame of the c3d file stored as frame 0
+	///
+	Timeline(float frameRate = FRAME_RATE, uint firstFrame = 0);
+	///
+	/// \brief get the frame rate
+	///	\return frames per second
+	///
+	float getFrameRate() const { return _frameRate; }
+	///
+	/// \brief set the frame rate
+	///	\param frameRate: frames per second, FRAME_RATE if not positive
+	///
+	void setFrameRate(float frameRate);
+	///
+	/// \brief get the frame of the c3d file stored as frame 0
+	///	\return frame index in the file
+	///
+	uint getFirstFrame() const { return _firstFrame; }
+	///
+	/// \brief set the frame of the c3d file stored as frame 0
+	///	\param firstFrame: frame index in the file
+	///
+	void setFirstFrame(uint firstFrame) { _firstFrame = firstFrame; }
+	///
+	/// \brief get the time between two frames
+	///	\return seconds
+	///
+	double getFramePeriod() const { return 1.0 / _frameRate; }
+	///
+	/// \brief get the time of a frame
+	///	\param frame: frame index
+	///	\return seconds from the first frame of the file
+	///
+	double getTime(uint frame) const { return (double(_firstFrame) + frame) / _frameRate; }
+	///
+	/// \brief get the frame closest to a time
+	///	\param time: seconds from the first frame of the file
+	///	\param numFrames: # of frames, the result is clamped to [0, numFrames - 1]
+	///	\return frame index
+	///
+	uint getFrame(double time, uint numFrames) const;
+	///
+	/// \brief convert a duration to a number of frames
+	///	\param seconds: duration
+	///	\return # of frames, rounded
+	///
+	uint getNumFrames(double seconds) const;
+}; // End of class Timeline
+
+}; // end of namespace Marker
+
+#endif
\ No newline at end of file
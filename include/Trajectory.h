@@ -0,0 +1,212 @@
+///
+/// \file Trajectory.h
+/// \brief Columnar storage of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "Settings.h"
+#include "MarkerData.h"
+#include "Timeline.h"
+
+namespace Marker
+{
+enum Axis {AXIS_X, AXIS_Y, AXIS_Z};
+
+const uint				NUM_AXES = 3;					///< x, y and z
+const uint				MASK_BITS = 64;					///< frames per validity word
+const uint				NO_MARKER = ~0u;				///< marker missing from the file
+
+///
+/// \class Trajectory
+/// \brief Positions of all markers over all frames.
+///
+/// Each marker owns three contiguous float columns (x, y, z) indexed by frame,
+/// and a packed validity mask with one bit per frame. Invalid samples are
+/// stored as NaN. A second mask flags the valid samples that were generated
+/// (e.g. interpolated) rather than measured. Frames are indexed by integer,
+/// their times come from the shared Timeline of the trajectory.
+///
+class Trajectory
+{
+private:
+	uint					_numFrames;			///< # of frames
+	Timeline				_timeline;			///< frame rate and frame of the c3d file stored as frame 0
+	uint					_numMarkers;		///< # of markers
+	uint					_maskWords;			///< validity words per marker
+	std::vector<float>		_positions;			///< [marker][axis][frame]
+	std::vector<uint64_t>	_validity;			///< [marker][frame / MASK_BITS]
+	std::vector<uint64_t>	_generated;			///< [marker][frame / MASK_BITS], subset of _validity
+	std::vector<uint>		_markerIDs;			///< point index in the file of each marker
+
+public:
+	///
+	/// \brief Constructor of an empty trajectory
+	///
+	Trajectory();
+	///
+	/// \brief Constructor, all samples invalid
+	///	\param numFrames: # of frames
+	///	\param numMarkers: # of markers
+	///
+	Trajectory(uint numFrames, uint numMarkers);
+	///
+	/// \brief resize the trajectory, all samples invalid, first frame 0 and marker i stores point i, the frame rate is kept
+	///	\param numFrames: # of frames
+	///	\param numMarkers: # of markers
+	///
+	void resize(uint numFrames, uint numMarkers);
+	///
+	/// \brief get the number of frames
+	///	\return # of frames
+	///
+	uint getNumFrames() const { return _numFrames; }
+	///
+	/// \brief get the frame of the c3d file stored as frame 0, non-zero for windows of a capture
+	///	\return frame index in the file
+	///
+	uint getFirstFrame() const { return _timeline.getFirstFrame(); }
+	///
+	/// \brief set the frame of the c3d file stored as frame 0
+	///	\param firstFrame: frame index in the file
+	///
+	void setFirstFrame(uint firstFrame);
+	///
+	/// \brief get the timeline of the frames
+	///	\return frame rate and first frame
+	///
+	const Timeline & getTimeline() const { return _timeline; }
+	///
+	/// \brief set the timeline of the frames
+	///	\param timeline: frame rate and first frame
+	///
+	void setTimeline(const Timeline & timeline);
+	///
+	/// \brief get the frame rate
+	///	\return frames per second
+	///
+	float getFrameRate() const { return _timeline.getFrameRate(); }
+	///
+	/// \brief set the frame rate
+	///	\param frameRate: frames per second, FRAME_RATE if not positive
+	///
+	void setFrameRate(float frameRate);
+	///
+	/// \brief get the time of a frame
+	///	\param frame: frame index
+	///	\return seconds from the first frame of the c3d file
+	///
+	double getTime(uint frame) const { return _timeline.getTime(frame); }
+	///
+	/// \brief get the frame closest to a time
+	///	\param time: seconds from the first frame of the c3d file
+	///	\return frame index, clamped to the frames of the trajectory
+	///
+	uint getFrame(double time) const { return _timeline.getFrame(time, _numFrames); }
+	///
+	/// \brief get the number of markers
+	///	\return # of markers
+	///
+	uint getNumMarkers() const { return _numMarkers; }
+	///
+	/// \brief get the point index in the c3d file of a marker
+	///	\param marker: marker index
+	///	\return point index, NO_MARKER if the point was not in the file
+	///
+	uint getMarkerID(uint marker) const { return _markerIDs[marker]; }
+	///
+	/// \brief set the point index in the c3d file of a marker
+	///	\param marker: marker index
+	///	\param markerID: point index
+	///
+	void setMarkerID(uint marker, uint markerID);
+	///
+	/// \brief find the marker stored for a point of the c3d file
+	///	\param markerID: point index
+	///	\return marker index, NO_MARKER if the point is not stored
+	///
+	uint findMarker(uint markerID) const;
+	///
+	/// \brief get one coordinate of a marker over all frames
+	///	\param marker: marker index
+	///	\param axis: coordinate
+	///	\return getNumFrames() contiguous values
+	///
+	const float * getColumn(uint marker, Axis axis) const { return _positions.data() + (std::size_t(marker) * NUM_AXES + axis) * _numFrames; }
+	float * getColumn(uint marker, Axis axis) { return _positions.data() + (std::size_t(marker) * NUM_AXES + axis) * _numFrames; }
+	///
+	/// \brief get the validity mask of a marker
+	///	\param marker: marker index
+	///	\return bit (frame % MASK_BITS) of word (frame / MASK_BITS) is set if valid
+	///
+	const uint64_t * getValidityMask(uint marker) const { return _validity.data() + std::size_t(marker) * _maskWords; }
+	uint64_t * getValidityMask(uint marker) { return _validity.data() + std::size_t(marker) * _maskWords; }
+	///
+	/// \brief get the mask of the generated samples of a marker
+	///	\return bit (frame % MASK_BITS) of word (frame / MASK_BITS) is set if generated
+	///
+	const uint64_t * getGeneratedMask(uint marker) const { return _generated.data() + std::size_t(marker) * _maskWords; }
+	uint64_t * getGeneratedMask(uint marker) { return _generated.data() + std::size_t(marker) * _maskWords; }
+	///
+	/// \brief get the number of validity words per marker
+	///	\return # of words
+	///
+	uint getMaskWords() const { return _maskWords; }
+	///
+	/// \brief get the position of a marker
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///	\return Position
+	///
+	Position getPosition(uint frame, uint marker) const
+	{
+		const float * x = getColumn(marker, AXIS_X) + frame;
+		Position position = {x[0], x[_numFrames], x[2 * _numFrames]};
+		return position;
+	}
+	///
+	/// \brief checks if a sample is valid
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///	\return true if valid
+	///
+	bool isValid(uint frame, uint marker) const { return (getValidityMask(marker)[frame / MASK_BITS] >> (frame % MASK_BITS)) & 1; }
+	///
+	/// \brief checks if a valid sample was generated rather than measured
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///	\return true if generated
+	///
+	bool isGenerated(uint frame, uint marker) const { return (getGeneratedMask(marker)[frame / MASK_BITS] >> (frame % MASK_BITS)) & 1; }
+	///
+	/// \brief set the position of a valid sample
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///	\param position: position of marker
+	///	\param generated: true if the sample was generated rather than measured
+	///
+	void setPosition(uint frame, uint marker, Position position, bool generated = false);
+	///
+	/// \brief mark a sample as invalid
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///
+	void invalidate(uint frame, uint marker);
+	///
+	/// \brief get one sample as marker data
+	///	\param frame: frame index
+	///	\param marker: marker index
+	///	\return marker data
+	///
+	MarkerData getMarkerData(uint frame, uint marker) const;
+}; // End of class Trajectory
+
+}; // end of namespace Marker
+
+#endif
\ No newline at end of file
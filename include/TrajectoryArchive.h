@@ -0,0 +1,168 @@
+///
+/// \file TrajectoryArchive.h
+/// \brief Compressed archive of trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef TRAJECTORYARCHIVE_H
+#define TRAJECTORYARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Settings.h"
+#include "Trajectory.h"
+
+namespace C3D
+{
+const uint				ARCHIVE_LABEL_SIZE = 32;		///< bytes per marker label in the archive
+const uint				ARCHIVE_BLOCK_SIZE = 64;		///< residuals sharing one Rice parameter
+const uint				ARCHIVE_HAS_GENERATED = 1;		///< column flag: a mask of the generated samples follows the validity mask
+
+///
+/// \struct ArchiveOptions
+/// \brief Settings of the encoder
+///
+struct ArchiveOptions
+{
+	float		precision;			///< quantisation step in mm
+	uint		predictorOrder;		///< 1: previous sample, 2: linear extrapolation of the two previous samples
+
+	ArchiveOptions(float precision = 0.01f, uint predictorOrder = 2) :
+		precision(precision),
+		predictorOrder(predictorOrder)
+	{
+	}
+};
+
+///
+/// \struct ArchiveHeader
+/// \brief First bytes of an archive, followed by the labels, the column index and the columns
+///
+struct ArchiveHeader
+{
+	char		magic[8];			///< "C3DARCH" and format version
+	uint32_t	numFrames;			///< # of frames
+	uint32_t	numMarkers;			///< # of columns
+	uint32_t	firstFrame;			///< frame of the c3d file stored as frame 0
+	uint32_t	predictorOrder;		///< predictor used by the encoder
+	double		precision;			///< quantisation step in mm
+	uint64_t	labelOffset;		///< offset of the labels, ARCHIVE_LABEL_SIZE bytes each
+	uint64_t	indexOffset;		///< offset of the ColumnIndex of each column
+	float		frameRate;			///< frames per second
+};
+
+///
+/// \struct ColumnIndex
+/// \brief Location of one marker column
+///
+struct ColumnIndex
+{
+	uint64_t	offset;				///< offset of the column: validity mask, generated mask if flagged, 3 stream sizes, 3 streams
+	uint64_t	size;				///< size of the column in bytes
+	uint32_t	markerID;			///< point index in the c3d file
+	uint32_t	flags;				///< ARCHIVE_HAS_GENERATED or 0
+};
+
+///
+/// \class TrajectoryArchive
+/// \brief Read-only mapping of a compressed trajectory archive.
+///
+/// Every coordinate is quantised to the precision, predicted from the
+/// previous valid samples of its column, and the zigzagged residuals are
+/// Rice coded in blocks of ARCHIVE_BLOCK_SIZE with one parameter per block.
+/// Validity masks are stored raw. Each marker column is self-contained, so
+/// a reader only touches the columns it asks for.
+///
+class TrajectoryArchive
+{
+	boost::interprocess::file_mapping				_mapping;		///< mapping of the archive
+	boost::interprocess::mapped_region				_region;		///< mapped view of the archive
+	const ArchiveHeader *							_header;		///< header, NULL if the archive is not valid
+	const ColumnIndex *								_index;			///< one entry per column
+
+public:
+	///
+	/// \brief Constructor, maps and validates an archive
+	///	\param fileName: archive file
+	///
+	TrajectoryArchive(std::string fileName);
+
+	///
+	/// \brief checks if the archive could be mapped and is consistent
+	///	\return true if valid
+	///
+	bool isValid() const;
+
+	///
+	/// \brief get the number of frames
+	///	\return # of frames
+	///
+	uint getNumFrames() const;
+
+	///
+	/// \brief get the number of marker columns
+	///	\return # of columns
+	///
+	uint getNumMarkers() const;
+
+	///
+	/// \brief get the quantisation step
+	///	\return precision in mm
+	///
+	double getPrecision() const;
+
+	///
+	/// \brief get the labels of the columns
+	///	\return one label per column
+	///
+	std::vector<std::string> getLabels() const;
+
+	///
+	/// \brief decode some of the columns into a trajectory
+	///	\param columns: column indices, out of range indices give invalid markers
+	///	\param trajectory: resized to the # of frames and columns
+	///	\return false if a column is corrupt
+	///
+	bool readMarkers(const std::vector<uint> & columns, Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief write an archive
+	///	\param fileName: archive file
+	///	\param trajectory: markers to store, one column each
+	///	\param labels: one label per marker
+	///	\param options: precision and predictor
+	///	\return true if written
+	///
+	static bool write(std::string fileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & labels, ArchiveOptions options = ArchiveOptions());
+
+private:
+	///
+	/// \brief encode one coordinate of a marker
+	///	\param column: values of all frames
+	///	\param validity: validity mask of the marker
+	///	\param numFrames: # of frames
+	///	\param options: precision and predictor
+	///	\param out: Rice coded residuals, appended
+	///
+	static void encodeStream(const float * column, const uint64_t * validity, uint numFrames, const ArchiveOptions & options, std::vector<unsigned char> & out);
+
+	///
+	/// \brief decode one coordinate of a marker, invalid frames are left untouched
+	///	\param in: first byte of the stream
+	///	\param size: size of the stream including padding
+	///	\param validity: validity mask of the marker
+	///	\param numFrames: # of frames
+	///	\param column: values of all frames
+	///	\return false if the stream is shorter than its content
+	///
+	bool decodeStream(const unsigned char * in, uint64_t size, const uint64_t * validity, uint numFrames, float * column) const;
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,130 @@
+///
+/// \file TrajectoryCache.h
+/// \brief Binary cache of decoded trajectories next to the c3d files
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef TRAJECTORYCACHE_H
+#define TRAJECTORYCACHE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Settings.h"
+#include "Trajectory.h"
+
+namespace C3D
+{
+const uint				CACHE_LABEL_SIZE = 32;			///< bytes per point label in the cache
+
+///
+/// \struct CacheHeader
+/// \brief First bytes of a cache file, followed by the labels, the columns, the validity masks and the generated masks
+///
+struct CacheHeader
+{
+	char		magic[8];			///< "C3DTRAJ" and format version
+	uint32_t	numFrames;			///< # of frames
+	uint32_t	numPoints;			///< # of points, every point of the c3d file is cached
+	uint64_t	sourceSize;			///< size of the c3d file in bytes
+	int64_t		sourceTime;			///< modification time of the c3d file
+	uint64_t	sourceHash;			///< hash of the content of the c3d file
+	uint64_t	pathHash;			///< hash of the path of the c3d file
+	uint64_t	labelOffset;		///< offset of the labels, CACHE_LABEL_SIZE bytes each
+	uint64_t	positionOffset;		///< offset of the columns, [point][axis][frame]
+	uint64_t	validityOffset;		///< offset of the masks, [point][frame / MASK_BITS]
+	uint64_t	generatedOffset;	///< offset of the masks of the generated samples, same layout
+	float		frameRate;			///< frames per second
+};
+
+///
+/// \class TrajectoryCache
+/// \brief Read-only mapping of the cache of one c3d file.
+///
+/// The cache is the file name of the c3d file with ".traj" appended. It is
+/// only used if the size, modification time, content hash and path of the
+/// c3d file still match the ones it was written for. The content hash is a
+/// pass over the whole c3d file, so short reads may skip it.
+///
+class TrajectoryCache
+{
+	boost::interprocess::file_mapping				_mapping;		///< mapping of the cache file
+	boost::interprocess::mapped_region				_region;		///< mapped view of the cache file
+	const CacheHeader *								_header;		///< header, NULL if the cache is not valid
+
+public:
+	///
+	/// \brief Constructor, maps and validates the cache of a c3d file
+	///	\param sourceFileName: c3d file
+	///	\param checkContent: false to skip the content hash, which reads the whole c3d file, and trust its size, modification time and path
+	///
+	TrajectoryCache(std::string sourceFileName, bool checkContent = true);
+
+	///
+	/// \brief checks if the cache exists and matches the c3d file
+	///	\return true if valid
+	///
+	bool isValid() const;
+
+	///
+	/// \brief get the number of frames
+	///	\return # of frames
+	///
+	uint getNumFrames() const;
+
+	///
+	/// \brief get the labels of the points
+	///	\return one label per point
+	///
+	std::vector<std::string> getPointLabels() const;
+
+	///
+	/// \brief copy some of the cached points into a trajectory
+	///	\param markers: point indices, out of range indices give invalid markers
+	///	\param trajectory: resized to the # of frames and markers, with the frame rate of the c3d file
+	///
+	void readMarkers(const std::vector<uint> & markers, Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief copy a window of frames of some of the cached points into a trajectory
+	///	\param markers: point indices, out of range indices give invalid markers
+	///	\param firstFrame: first frame of the window
+	///	\param numFrames: # of frames, clamped to the end of the cache
+	///	\param trajectory: resized to the window and markers, its first frame is firstFrame
+	///
+	void readMarkers(const std::vector<uint> & markers, uint firstFrame, uint numFrames, Marker::Trajectory & trajectory) const;
+
+	///
+	/// \brief write the cache of a c3d file
+	///	\param sourceFileName: c3d file
+	///	\param trajectory: every point of the c3d file
+	///	\param pointLabels: one label per point
+	///	\return true if written
+	///
+	static bool write(std::string sourceFileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & pointLabels);
+
+	///
+	/// \brief get the cache file of a c3d file
+	///	\param sourceFileName: c3d file
+	///	\return cache file name
+	///
+	static std::string getCacheFileName(std::string sourceFileName);
+
+private:
+	///
+	/// \brief describe the c3d file as it is now
+	///	\param sourceFileName: c3d file
+	///	\param header: source fields to fill
+	///	\param hashContent: false to leave the content hash at 0 without reading the c3d file
+	///	\return false if the c3d file cannot be read
+	///
+	static bool describeSource(std::string sourceFileName, CacheHeader & header, bool hashContent = true);
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+///
+/// \file TrajectoryExporter.h
+/// \brief Text export of trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef TRAJECTORYEXPORTER_H
+#define TRAJECTORYEXPORTER_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Settings.h"
+#include "Trajectory.h"
+#include "DatasetLoader.h"
+
+namespace C3D
+{
+enum ExportFormat {EXPORT_TSV, EXPORT_CSV};
+
+const uint				EXPORT_BUFFER_SIZE = 1 << 20;	///< bytes formatted before each write
+
+///
+/// \class TrajectoryExporter
+/// \brief Writes trajectories as delimited text, one row per frame.
+///
+/// Columns are the frame followed by x, y and z of every marker. Values are
+/// the shortest decimals that read back as the same float (floatToChars),
+/// invalid samples are written as NaN. Rows are formatted into a buffer that
+/// is written once full.
+///
+class TrajectoryExporter
+{
+	ExportFormat									_format;		///< separator of the columns
+	uint											_numThreads;	///< # of worker threads of writeAll
+
+public:
+	///
+	/// \brief Constructor
+	///	\param format: tab or comma separated
+	///	\param numThreads: # of worker threads of writeAll, 0 for one per hardware thread
+	///
+	TrajectoryExporter(ExportFormat format = EXPORT_TSV, uint numThreads = 0);
+
+	///
+	/// \brief write one trajectory
+	///	\param fileName: text file
+	///	\param trajectory: markers to write
+	///	\param labels: one label per marker, "M" and the marker ID if empty
+	///	\return false if the file cannot be written
+	///
+	bool write(std::string fileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & labels = std::vector<std::string>()) const;
+
+	///
+	/// \brief write many trajectories concurrently, one file per capture named subject_sequence
+	///	\param directory: output directory
+	///	\param trajectories: captures to write
+	///	\param labels: one label per marker, "M" and the marker ID if empty
+	///	\return # of files written
+	///
+	uint writeAll(std::string directory, const std::map<SequenceKey, Marker::Trajectory> & trajectories, const std::vector<std::string> & labels = std::vector<std::string>()) const;
+
+	///
+	/// \brief get the file extension of the format
+	///	\return ".tsv" or ".csv"
+	///
+	std::string getExtension() const;
+};
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+///
+/// \file ValidityIndex.h
+/// \brief Queries on the valid frames of a trajectory
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#ifndef VALIDITYINDEX_H
+#define VALIDITYINDEX_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "Settings.h"
+#include "Trajectory.h"
+
+namespace Marker
+{
+///
+/// \struct FrameRun
+/// \brief Consecutive frames [first, first + length)
+///
+struct FrameRun
+{
+	uint first;					///< first frame
+	uint length;				///< # of frames
+
+	FrameRun(uint first = 0, uint length = 0) :
+		first(first),
+		length(length)
+	{
+	}
+
+	uint end() const { return first + length; }
+};
+
+///
+/// \class ValidityIndex
+/// \brief Index of the validity masks of a loaded trajectory.
+///
+/// Prefix counts of the valid frames per mask word answer "how many valid
+/// frames in a window" in O(1), and the sorted gaps of each marker answer
+/// "where are the gaps" in O(log n). Kernels iterate over getValidRuns()
+/// instead of testing every sample. The index is a snapshot: it is not
+/// updated if the trajectory changes.
+///
+class ValidityIndex
+{
+	uint					_numFrames;			///< # of frames
+	uint					_numMarkers;		///< # of markers
+	uint					_maskWords;			///< validity words per marker
+	std::vector<uint64_t>	_validity;			///< copy of the masks, [marker][frame / MASK_BITS]
+	std::vector<uint32_t>	_prefixCounts;		///< [marker][word], valid frames before the word, _maskWords + 1 per marker
+	std::vector<FrameRun>	_gaps;				///< gaps of every marker, by marker then frame
+	std::vector<uint>		_gapStart;			///< first gap of each marker, then the # of gaps
+
+public:
+	///
+	/// \brief Constructor of an empty index
+	///
+	ValidityIndex();
+	///
+	/// \brief Constructor
+	///	\param trajectory: loaded trajectory
+	///
+	ValidityIndex(const Trajectory & trajectory);
+	///
+	/// \brief index a trajectory
+	///	\param trajectory: loaded trajectory
+	///
+	void build(const Trajectory & trajectory);
+	///
+	/// \brief count the valid frames of a window, O(1)
+	///	\param marker: marker index
+	///	\param first: first frame
+	///	\param last: frame after the window, clamped to the # of frames
+	///	\return # of valid frames
+	///
+	uint countValid(uint marker, uint first, uint last) const;
+	///
+	/// \brief checks if a marker is valid over a whole window, O(1)
+	///	\param marker: marker index
+	///	\param first: first frame
+	///	\param last: frame after the window
+	///	\return true if every frame of the window is valid
+	///
+	bool isValid(uint marker, uint first, uint last) const;
+	///
+	/// \brief checks if every marker is valid over a whole window, O(# of markers)
+	///	\param first: first frame
+	///	\param last: frame after the window
+	///	\return true if every sample of the window is valid
+	///
+	bool isValid(uint first, uint last) const;
+	///
+	/// \brief get the number of gaps of a marker
+	///	\param marker: marker index
+	///	\return # of runs of invalid frames
+	///
+	uint getNumGaps(uint marker) const;
+	///
+	/// \brief get the gaps of a marker overlapping a window, O(log n) plus the # of gaps returned
+	///	\param marker: marker index
+	///	\param first: first frame
+	///	\param last: frame after the window
+	///	\return runs of invalid frames, clipped to the window
+	///
+	std::vector<FrameRun> getGaps(uint marker, uint first, uint last) const;
+	///
+	/// \brief get the valid runs of a marker in a window, the complement of getGaps()
+	///	\param marker: marker index
+	///	\param first: first frame
+	///	\param last: frame after the window
+	///	\return runs of valid frames, clipped to the window
+	///
+	std::vector<FrameRun> getValidRuns(uint marker, uint first, uint last) const;
+	///
+	/// \brief find the first valid frame of a marker at or after a frame, O(log n)
+	///	\param marker: marker index
+	///	\param frame: frame index
+	///	\return valid frame, the # of frames if there is none
+	///
+	uint findNextValid(uint marker, uint frame) const;
+
+private:
+	///
+	/// \brief count the valid frames before a frame
+	///	\param marker: marker index
+	///	\param frame: frame index, at most the # of frames
+	///	\return # of valid frames in [0, frame)
+	///
+	uint countBefore(uint marker, uint frame) const;
+	///
+	/// \brief find the first gap of a marker ending after a frame
+	///	\param marker: marker index
+	///	\param frame: frame index
+	///	\return index in _gaps, _gapStart[marker + 1] if there is none
+	///
+	uint findGap(uint marker, uint frame) const;
+}; // End of class ValidityIndex
+
+}; // end of namespace Marker
+
+#endif
\ No newline at end of file
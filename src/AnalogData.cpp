@@ -0,0 +1,47 @@
+///
+/// \file AnalogData.cpp
+/// \brief Contiguous storage of analog channels
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "AnalogData.h"
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+AnalogData::AnalogData() :
+	_numChannels(0),
+	_numFrames(0),
+	_samplesPerFrame(0),
+	_sampleRate(0)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+void AnalogData::resize(uint numChannels, uint numFrames, uint samplesPerFrame)
+{
+	_numChannels = numChannels;
+	_numFrames = numFrames;
+	_samplesPerFrame = samplesPerFrame;
+	_samples.assign(std::size_t(numChannels) * numFrames * samplesPerFrame, 0.0f);
+	_labels.assign(numChannels, std::string());
+}
+
+void AnalogData::setSampleRate(float sampleRate)
+{
+	_sampleRate = sampleRate;
+}
+
+void AnalogData::setLabel(uint channel, std::string label)
+{
+	_labels[channel] = label;
+}
+
+uint AnalogData::findChannel(std::string label) const
+{
+	for(uint channel = 0; channel < _numChannels; channel++)
+		if(_labels[channel] == label)
+			return channel;
+	return NO_CHANNEL;
+}
\ No newline at end of file
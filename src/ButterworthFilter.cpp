@@ -0,0 +1,297 @@
+///
+/// \file ButterworthFilter.cpp
+/// \brief Zero-phase low-pass filtering of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "ButterworthFilter.h"
+#include "ValidityIndex.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+#ifdef __SSE2__
+#define BUTTERWORTH_FILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace C3D;
+
+static const double FILTER_PI = 3.14159265358979323846;
+static const uint MAX_SECTIONS = (FILTER_MAX_ORDER + 1) / 2;
+static const double PAD_DECAY = 1e-6;
+
+///
+/// \struct FilterJob
+/// \brief One valid run of one column
+///
+struct FilterJob
+{
+	float *		column;				///< first frame of the column
+	uint		first;				///< first frame of the run
+	uint		length;				///< # of frames of the run
+
+	bool operator<(const FilterJob & other) const
+	{
+		return first < other.first || (first == other.first && length < other.length);
+	}
+};
+
+#ifndef BUTTERWORTH_FILTER_SSE2
+// --------------------------------------------------------- Scalar kernels
+///
+/// \brief run the cascade over interleaved lanes, in place
+///	\param sections: cascade of sections
+///	\param steady1: first state of each section for a unit input
+///	\param steady2: second state of each section for a unit input
+///	\param buffer: total * FILTER_LANES samples, lane after lane for each frame
+///	\param total: # of frames
+///	\param backward: run from the last frame to the first
+///
+static void runCascadeScalar(const std::vector<BiquadSection> & sections, const double * steady1, const double * steady2, double * buffer, uint total, bool backward)
+{
+	uint numSections = sections.size();
+	double z1[MAX_SECTIONS][FILTER_LANES];
+	double z2[MAX_SECTIONS][FILTER_LANES];
+	const double * start = backward ? buffer + std::size_t(total - 1) * FILTER_LANES : buffer;
+	for(uint section = 0; section < numSections; section++)
+		for(uint lane = 0; lane < FILTER_LANES; lane++)
+		{
+			z1[section][lane] = steady1[section] * start[lane];
+			z2[section][lane] = steady2[section] * start[lane];
+		}
+
+	for(uint n = 0; n < total; n++)
+	{
+		double * samples = buffer + std::size_t(backward ? total - 1 - n : n) * FILTER_LANES;
+		for(uint section = 0; section < numSections; section++)
+		{
+			const BiquadSection & s = sections[section];
+			for(uint lane = 0; lane < FILTER_LANES; lane++)
+			{
+				double x = samples[lane];
+				double y = s.b0 * x + z1[section][lane];
+				z1[section][lane] = s.b1 * x - s.a1 * y + z2[section][lane];
+				z2[section][lane] = s.b2 * x - s.a2 * y;
+				samples[lane] = y;
+			}
+		}
+	}
+}
+#else
+// --------------------------------------------------------- SSE2 kernels
+///
+/// \brief run the cascade over interleaved lanes, in place, see runCascadeScalar
+///
+static void runCascadeSSE2(const std::vector<BiquadSection> & sections, const double * steady1, const double * steady2, double * buffer, uint total, bool backward)
+{
+	// FILTER_LANES doubles are two registers, lanes 0 1 and lanes 2 3
+	uint numSections = sections.size();
+	__m128d b0[MAX_SECTIONS], b1[MAX_SECTIONS], b2[MAX_SECTIONS], a1[MAX_SECTIONS], a2[MAX_SECTIONS];
+	__m128d z1[MAX_SECTIONS][2], z2[MAX_SECTIONS][2];
+	const double * start = backward ? buffer + std::size_t(total - 1) * FILTER_LANES : buffer;
+	for(uint section = 0; section < numSections; section++)
+	{
+		b0[section] = _mm_set1_pd(sections[section].b0);
+		b1[section] = _mm_set1_pd(sections[section].b1);
+		b2[section] = _mm_set1_pd(sections[section].b2);
+		a1[section] = _mm_set1_pd(sections[section].a1);
+		a2[section] = _mm_set1_pd(sections[section].a2);
+		for(uint half = 0; half < 2; half++)
+		{
+			__m128d x = _mm_loadu_pd(start + 2 * half);
+			z1[section][half] = _mm_mul_pd(_mm_set1_pd(steady1[section]), x);
+			z2[section][half] = _mm_mul_pd(_mm_set1_pd(steady2[section]), x);
+		}
+	}
+
+	for(uint n = 0; n < total; n++)
+	{
+		double * samples = buffer + std::size_t(backward ? total - 1 - n : n) * FILTER_LANES;
+		__m128d x[2] = {_mm_loadu_pd(samples), _mm_loadu_pd(samples + 2)};
+		for(uint section = 0; section < numSections; section++)
+		{
+			for(uint half = 0; half < 2; half++)
+			{
+				__m128d y = _mm_add_pd(_mm_mul_pd(b0[section], x[half]), z1[section][half]);
+				z1[section][half] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1[section], x[half]), _mm_mul_pd(a1[section], y)), z2[section][half]);
+				z2[section][half] = _mm_sub_pd(_mm_mul_pd(b2[section], x[half]), _mm_mul_pd(a2[section], y));
+				x[half] = y;
+			}
+		}
+		_mm_storeu_pd(samples, x[0]);
+		_mm_storeu_pd(samples + 2, x[1]);
+	}
+}
+#endif
+
+// --------------------------------------------------------- Constructors
+ButterworthFilter::ButterworthFilter(uint order, float cutoff, uint numThreads) :
+	_order(order),
+	_cutoff(cutoff),
+	_numThreads(numThreads)
+{
+	if(order == 0 || order > FILTER_MAX_ORDER)
+	{
+		std::cerr << "C3D::ButterworthFilter::ButterworthFilter(): Order " << order << " out of [1, " << FILTER_MAX_ORDER << "]" << std::endl;
+		_order = std::min(std::max(order, 1u), FILTER_MAX_ORDER);
+	}
+}
+
+// --------------------------------------------------------- Public Functions
+std::vector<BiquadSection> ButterworthFilter::getSections(float frameRate) const
+{
+	std::vector<BiquadSection> sections;
+	if(!(_cutoff > 0) || !(_cutoff < frameRate / 2))
+		return sections;
+
+	// prewarped cutoff of the bilinear transform
+	double k = std::tan(FILTER_PI * _cutoff / frameRate);
+	double k2 = k * k;
+	for(uint pair = 0; pair < _order / 2; pair++)
+	{
+		// each pair of analog poles at angle PI (2 pair + 1) / (2 order) from the imaginary axis
+		double damping = 2 * std::sin(FILTER_PI * (2 * pair + 1) / (2 * _order));
+		double norm = 1 / (1 + damping * k + k2);
+		BiquadSection section;
+		section.b0 = k2 * norm;
+		section.b1 = 2 * section.b0;
+		section.b2 = section.b0;
+		section.a1 = 2 * (k2 - 1) * norm;
+		section.a2 = (1 - damping * k + k2) * norm;
+		sections.push_back(section);
+	}
+	if(_order % 2)
+	{
+		// the real pole of an odd order
+		double norm = 1 / (1 + k);
+		BiquadSection section;
+		section.b0 = k * norm;
+		section.b1 = section.b0;
+		section.b2 = 0;
+		section.a1 = (k - 1) * norm;
+		section.a2 = 0;
+		sections.push_back(section);
+	}
+	return sections;
+}
+
+bool ButterworthFilter::apply(Marker::Trajectory & trajectory) const
+{
+	std::vector<BiquadSection> sections = getSections(trajectory.getFrameRate());
+	if(sections.empty())
+	{
+		std::cerr << "C3D::ButterworthFilter::apply(): Cutoff " << _cutoff << " Hz is not below half the frame rate " << trajectory.getFrameRate() << std::endl;
+		return false;
+	}
+
+	// the x y z columns of a marker share its valid runs, columns with the same run are filtered together
+	Marker::ValidityIndex validity(trajectory);
+	std::vector<FilterJob> jobs;
+	for(uint marker = 0; marker < trajectory.getNumMarkers(); marker++)
+	{
+		std::vector<Marker::FrameRun> runs = validity.getValidRuns(marker, 0, trajectory.getNumFrames());
+		for(uint run = 0; run < runs.size(); run++)
+			for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			{
+				FilterJob job = {trajectory.getColumn(marker, Marker::Axis(axis)), runs[run].first, runs[run].length};
+				jobs.push_back(job);
+			}
+	}
+	std::stable_sort(jobs.begin(), jobs.end());
+
+	std::vector<double> scratch;
+	float * columns[FILTER_LANES];
+	for(uint job = 0; job < jobs.size(); )
+	{
+		uint numColumns = 0;
+		uint first = jobs[job].first;
+		uint length = jobs[job].length;
+		for(; job < jobs.size() && numColumns < FILTER_LANES && jobs[job].first == first && jobs[job].length == length; job++)
+			columns[numColumns++] = jobs[job].column + first;
+		filterColumns(sections, columns, numColumns, length, scratch);
+	}
+	return true;
+}
+
+uint ButterworthFilter::applyAll(std::map<SequenceKey, Marker::Trajectory> & trajectories) const
+{
+	std::atomic<uint> numFiltered(0);
+	{
+		ThreadPool pool(_numThreads);
+		for(std::map<SequenceKey, Marker::Trajectory>::iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		{
+			Marker::Trajectory * trajectory = &it->second;
+			pool.submit([this, trajectory, &numFiltered]()
+			{
+				if(apply(*trajectory))
+					numFiltered++;
+			});
+		}
+		pool.wait();
+	}
+	return numFiltered;
+}
+
+void ButterworthFilter::filterColumns(const std::vector<BiquadSection> & sections, float * const * columns, uint numColumns, uint length, std::vector<double> & scratch)
+{
+	uint numSections = std::min<uint>(sections.size(), MAX_SECTIONS);
+	if(length == 0 || numSections == 0 || numColumns == 0)
+		return;
+	std::vector<BiquadSection> cascade(sections.begin(), sections.begin() + numSections);
+
+	// odd reflection at both ends, long enough for the slowest pole to decay below PAD_DECAY, but shorter than the run
+	double radius = 0;
+	for(uint section = 0; section < numSections; section++)
+		radius = std::max(radius, cascade[section].a2 > 0 ? std::sqrt(cascade[section].a2) : std::fabs(cascade[section].a1));
+	uint pad = radius > 0 ? uint(std::ceil(std::log(PAD_DECAY) / std::log(radius))) : 1;
+	pad = std::min(pad, length - 1);
+	uint total = length + 2 * pad;
+	scratch.resize(std::size_t(total) * FILTER_LANES);
+	double * buffer = scratch.data();
+	for(uint lane = 0; lane < FILTER_LANES; lane++)
+	{
+		// spare lanes repeat the first column and are not written back
+		const float * column = columns[lane < numColumns ? lane : 0];
+		double * out = buffer + lane;
+		for(uint i = 0; i < length; i++)
+			out[std::size_t(pad + i) * FILTER_LANES] = column[i];
+		for(uint i = 0; i < pad; i++)
+		{
+			out[std::size_t(pad - 1 - i) * FILTER_LANES] = 2.0 * column[0] - column[i + 1];
+			out[std::size_t(pad + length + i) * FILTER_LANES] = 2.0 * column[length - 1] - column[length - 2 - i];
+		}
+	}
+
+	// steady state of each section for a unit step, scaled by the gain of the sections before it
+	double steady1[MAX_SECTIONS];
+	double steady2[MAX_SECTIONS];
+	double level = 1.0;
+	for(uint section = 0; section < numSections; section++)
+	{
+		const BiquadSection & s = cascade[section];
+		double gain = (s.b0 + s.b1 + s.b2) / (1 + s.a1 + s.a2);
+		steady1[section] = (gain - s.b0) * level;
+		steady2[section] = (s.b2 - s.a2 * gain) * level;
+		level *= gain;
+	}
+
+#ifdef BUTTERWORTH_FILTER_SSE2
+	runCascadeSSE2(cascade, steady1, steady2, buffer, total, false);
+	runCascadeSSE2(cascade, steady1, steady2, buffer, total, true);
+#else
+	runCascadeScalar(cascade, steady1, steady2, buffer, total, false);
+	runCascadeScalar(cascade, steady1, steady2, buffer, total, true);
+#endif
+
+	for(uint lane = 0; lane < numColumns; lane++)
+	{
+		const double * in = buffer + std::size_t(pad) * FILTER_LANES + lane;
+		float * column = columns[lane];
+		for(uint i = 0; i < length; i++)
+			column[i] = float(in[std::size_t(i) * FILTER_LANES]);
+	}
+}
\ No newline at end of file
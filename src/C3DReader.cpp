@@ -6,62 +6,258 @@
 ///
 
 #include "C3DReader.h"
-#include <fstream>
+#include "MappedC3DFile.h"
+#include "TrajectoryCache.h"
+#include "C3DWriter.h"
+#include "HeaderTemplateCache.h"
+#include "LabelResolver.h"
+#include <algorithm>
 
 using namespace C3D;
 
 C3DReader::C3DReader(uint numMarkers, uint frameRate) : 
 	_numMarkers(numMarkers), 
-	_frameRate(frameRate)
-{
-	std::string fileName = "..//data//Sample.c3d";
-	std::ifstream sampleFileIn(fileName);
-	if(sampleFileIn)
-		_fileInfo = new UuIcsC3d::C3dFileInfo(fileName);
-	else
-		std::cerr << "C3D::C3DReader::C3DReader(): Cannot find ..//data//Sample.c3d" << std::endl;
+	_frameRate(frameRate),
+	_useCache(true)
+{
+	_fileInfo = HeaderTemplateCache::get("..//data//Sample.c3d", numMarkers);
+}
+
+void C3DReader::setMarkerSubset(std::vector<uint> markers)
+{
+	_markerSubset = markers;
+	_labelSubset.clear();
+	_layoutSubset.reset();
+}
+
+void C3DReader::setMarkerSubset(std::vector<std::string> labels)
+{
+	_labelSubset = labels;
+	_markerSubset.clear();
+	_layoutSubset.reset();
 }
 
-void C3DReader::writeToC3D(std::string fileName, std::vector<UuIcsC3d::FrameData> data)
+void C3DReader::setMarkerSubset(const MarkerLayout & layout)
 {
-	bool success = UuIcsC3d::write(fileName, *_fileInfo, data, get_pointer(UuIcsC3d::get_native_io()));
+	_layoutSubset = std::make_shared<const MarkerLayout>(layout);
+	_markerSubset.clear();
+	_labelSubset.clear();
+}
+
+void C3DReader::clearMarkerSubset()
+{
+	_markerSubset.clear();
+	_labelSubset.clear();
+	_layoutSubset.reset();
+}
+
+void C3DReader::setCacheEnabled(bool useCache)
+{
+	_useCache = useCache;
+}
+
+void C3DReader::writeToC3D(std::string fileName, const std::vector<UuIcsC3d::FrameData> & data)
+{
+	if(!_fileInfo)
+	{
+		std::cerr << "C3D::C3DReader::writeToC3D(): No header template, cannot write to the file: " << fileName << std::endl;
+		return;
+	}
+	C3DWriter outFile(fileName, *_fileInfo, _frameRate);
+	bool success = outFile.writeFrames(data) && outFile.close();
 
 	if(DEBUG)
 		if(!success)
 			std::cout << "C3D::C3DReader::writeToC3D(): Cannot write to the file: " << fileName << std::endl;
 }
 
-std::vector<std::map<uint, Marker::MarkerData > > C3DReader::readAllFrames(std::string fileName)
+Marker::Trajectory C3DReader::readAllFrames(std::string fileName)
+{
+	Marker::Trajectory trajectory;
+	if(_useCache)
+	{
+		TrajectoryCache cache(fileName);
+		if(cache.isValid())
+		{
+			cache.readMarkers(selectMarkers(cache.getPointLabels()), trajectory);
+			return trajectory;
+		}
+	}
+
+	MappedC3DFile inFile(fileName);
+	if (inFile.getFrameCount() == 0) 
+	{
+		std::cerr << "There are no frames in the input file: " << fileName << "\n";
+		return trajectory;
+	}
+
+	std::vector<std::string> pointLabels = inFile.getPointLabels();
+	std::vector<uint> markers = selectMarkers(pointLabels);
+	if(_useCache)
+	{
+		// the cache holds every point, so that any subset can be served from it
+		std::vector<uint> allPoints(inFile.getNumPoints());
+		for(uint i = 0; i < allPoints.size(); i++)
+			allPoints[i] = i;
+		Marker::Trajectory allTrajectory = decodeFrames(inFile, allPoints, 0, inFile.getFrameCount());
+		if(TrajectoryCache::write(fileName, allTrajectory, pointLabels))
+		{
+			TrajectoryCache cache(fileName);
+			if(cache.isValid())
+			{
+				cache.readMarkers(markers, trajectory);
+				return trajectory;
+			}
+		}
+		if(markers == allPoints)
+			return allTrajectory;
+	}
+	return decodeFrames(inFile, markers, 0, inFile.getFrameCount());
+}
+
+Marker::Trajectory C3DReader::readFrameWindow(std::string fileName, uint firstFrame, uint lastFrame)
 {
-	UuIcsC3d::C3dFileInfo inFileInfo(fileName);
-	uint inFrameCount = inFileInfo.frame_count();
-	std::vector< std::map<uint, Marker::MarkerData > > frameMarkerData;
+	Marker::Trajectory trajectory;
+	if(_useCache)
+	{
+		// a window must not cost a pass over the whole file, the cache is trusted on size, time and path
+		TrajectoryCache cache(fileName, false);
+		if(cache.isValid())
+		{
+			uint numFrames = lastFrame > firstFrame ? lastFrame - firstFrame : 0;
+			cache.readMarkers(selectMarkers(cache.getPointLabels()), firstFrame, numFrames, trajectory);
+			return trajectory;
+		}
+	}
 
+	MappedC3DFile inFile(fileName);
+	return readFrameWindow(inFile, firstFrame, lastFrame);
+}
+
+Marker::Trajectory C3DReader::readFrameWindow(const MappedC3DFile & file, uint firstFrame, uint lastFrame)
+{
+	uint inFrameCount = file.getFrameCount();
+	if(lastFrame > inFrameCount)
+		lastFrame = inFrameCount;
+	if(firstFrame > lastFrame)
+		firstFrame = lastFrame;
+	return decodeFrames(file, selectMarkers(file.getPointLabels()), firstFrame, lastFrame - firstFrame);
+}
+
+uint C3DReader::readAllPoints(std::string fileName, std::vector<float> & positions, std::vector<float> & residuals)
+{
+	MappedC3DFile inFile(fileName);
+	uint inFrameCount = inFile.getFrameCount();
 	if (inFrameCount == 0) 
 	{
 		std::cerr << "There are no frames in the input file: " << fileName << "\n";
-		return frameMarkerData;
+		return 0;
 	}
 
-	std::auto_ptr<UuIcsC3d::C3dFile> inFilePointer = inFileInfo.open();
-	
-	for (uint i = 0; i < inFrameCount; ++i) 
+	std::vector<uint> markers = selectMarkers(inFile.getPointLabels());
+	positions.resize(std::size_t(inFrameCount) * markers.size() * 3);
+	residuals.resize(std::size_t(inFrameCount) * markers.size());
+	return inFile.readPoints(0, inFrameCount, markers, positions.data(), residuals.data());
+}
+
+AnalogData C3DReader::readAnalog(std::string fileName)
+{
+	AnalogData analog;
+	MappedC3DFile inFile(fileName);
+	if (inFile.getFrameCount() == 0) 
+	{
+		std::cerr << "There are no frames in the input file: " << fileName << "\n";
+		return analog;
+	}
+
+	inFile.readAnalog(0, inFile.getFrameCount(), analog);
+	return analog;
+}
+
+bool C3DReader::writeArchive(std::string fileName, std::string archiveFileName, ArchiveOptions options)
+{
+	MappedC3DFile inFile(fileName);
+	if (inFile.getFrameCount() == 0) 
+	{
+		std::cerr << "There are no frames in the input file: " << fileName << "\n";
+		return false;
+	}
+
+	// the archive holds every point, so that any subset can be served from it
+	std::vector<uint> allPoints(inFile.getNumPoints());
+	for(uint i = 0; i < allPoints.size(); i++)
+		allPoints[i] = i;
+	Marker::Trajectory allTrajectory = decodeFrames(inFile, allPoints, 0, inFile.getFrameCount());
+	return TrajectoryArchive::write(archiveFileName, allTrajectory, inFile.getPointLabels(), options);
+}
+
+Marker::Trajectory C3DReader::readArchive(std::string archiveFileName)
+{
+	Marker::Trajectory trajectory;
+	TrajectoryArchive archive(archiveFileName);
+	if(archive.isValid())
+		archive.readMarkers(selectMarkers(archive.getLabels()), trajectory);
+	return trajectory;
+}
+
+// --------------------------------------------------------- Private Functions
+std::vector<uint> C3DReader::selectMarkers(const std::vector<std::string> & pointLabels)
+{
+	if(_layoutSubset)
+		return LabelResolver::resolve(pointLabels, *_layoutSubset)->getAllPoints();
+
+	std::vector<uint> markers = _markerSubset;
+	if(!_labelSubset.empty())
+	{
+		for(uint i = 0; i < _labelSubset.size(); i++)
+		{
+			uint index = std::find(pointLabels.begin(), pointLabels.end(), _labelSubset[i]) - pointLabels.begin();
+			if(index == pointLabels.size())
+			{
+				std::cerr << "C3D::C3DReader::selectMarkers(): No point labelled " << _labelSubset[i] << std::endl;
+				index = Marker::NO_MARKER;
+			}
+			markers.push_back(index);
+		}
+	}
+	else if(markers.empty())
+	{
+		markers.resize(pointLabels.size());
+		for(uint i = 0; i < markers.size(); i++)
+			markers[i] = i;
+	}
+	return markers;
+}
+
+Marker::Trajectory C3DReader::decodeFrames(const MappedC3DFile & file, const std::vector<uint> & markers, uint firstFrame, uint numFrames)
+{
+	uint numMarkers = markers.size();
+	Marker::Trajectory trajectory(numFrames, numMarkers);
+	trajectory.setTimeline(Marker::Timeline(file.getFrameRate(), firstFrame));
+	for(uint marker = 0; marker < numMarkers; marker++)
+		trajectory.setMarkerID(marker, markers[marker] < file.getNumPoints() ? markers[marker] : Marker::NO_MARKER);
+
+	// decode a block of frames at a time and scatter it into the columns
+	const uint blockFrames = 256;
+	std::vector<float> positions(blockFrames * numMarkers * 3);
+	std::vector<float> residuals(blockFrames * numMarkers);
+	for (uint first = 0; first < numFrames; first += blockFrames) 
 	{
-		UuIcsC3d::FrameData frameData;
-		inFilePointer->get_frame_data(frameData, i);
-		std::map<uint, Marker::MarkerData > frameMarkers;
-		for(uint markerID = 0; markerID < frameData.points.size(); markerID++)
+		uint count = file.readPoints(firstFrame + first, std::min(blockFrames, numFrames - first), markers, positions.data(), residuals.data());
+		for(uint marker = 0; marker < numMarkers; marker++)
 		{
-			Marker::MarkerData marker;//(new Marker::MarkerData());
-			marker.setPositionX(frameData.points[markerID].x());
-			marker.setPositionY(frameData.points[markerID].y());
-			marker.setPositionZ(frameData.points[markerID].z());
-			
-			frameMarkers.insert(std::make_pair(markerID, marker));
+			for(uint i = 0; i < count; ++i)
+			{
+				// a negative residual marks an invalid point, a zero residual a generated one
+				float residual = residuals[i * numMarkers + marker];
+				if(residual < 0)
+					continue;
+				const float * point = &positions[(i * numMarkers + marker) * 3];
+				Marker::Position position = {point[0], point[1], point[2]};
+				trajectory.setPosition(first + i, marker, position, residual == 0);
+			}
 		}
-		frameMarkerData.push_back(frameMarkers);
 	}
 
-	inFilePointer.reset();
-	return frameMarkerData;
+	return trajectory;
 }
\ No newline at end of file
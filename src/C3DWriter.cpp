@@ -0,0 +1,332 @@
+///
+/// \file C3DWriter.cpp
+/// \brief Incremental writing of c3d files
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "C3DWriter.h"
+#include "MappedC3DFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace C3D;
+
+static const uint BLOCK_SIZE = sizeof(UuIcsC3d::Block);
+static const uint BUFFER_BLOCKS = 128;							///< blocks buffered before writing
+static const std::streamoff LAST_FRAME_OFFSET = 8;				///< header word 5
+static const std::streamoff PARAMETER_OFFSET = BLOCK_SIZE;		///< parameters start at block 2
+static const uint MAX_SHORT_FRAMES = 65535;						///< largest frame count of a 16-bit field
+
+///
+/// \brief get the analog channels of a template from header word 2, channels times samples per frame
+///
+/// frame_size is not updated by C3dFileInfo::set_points_per_frame(), so
+/// MappedC3DFile::getAnalogChannels() is wrong on a template whose point
+/// count was overridden, see HeaderTemplateCache. The header word is not.
+///
+static uint getTemplateAnalogChannels(const UuIcsC3d::C3dFileInfo & fileTemplate)
+{
+	int samples = fileTemplate.analog_samples_per_frame();
+	int analogWords = fileTemplate.content().header().analog_per_frame;
+	if(samples <= 0 || analogWords <= 0)
+		return 0;
+	return analogWords / samples;
+}
+
+///
+/// \brief append a group or a parameter in the c3d parameter format
+///
+static void appendItem(std::vector<unsigned char> & out, const UuIcsC3d::GroupParamCommon & item, int id, const std::vector<unsigned char> & body, const UuIcsC3d::BasicIO & encoder)
+{
+	std::string name = item.name().substr(0, 127);
+	std::string description = item.description().substr(0, 255);
+	signed char nameLength = name.size();
+	out.push_back(item.is_locked() ? -nameLength : nameLength);
+	out.push_back(static_cast<unsigned char>(static_cast<signed char>(id)));
+	out.insert(out.end(), name.begin(), name.end());
+
+	unsigned char offset[2];
+	encoder.encode(offset, static_cast<short>(2 + body.size() + 1 + description.size()));
+	out.insert(out.end(), offset, offset + 2);
+	out.insert(out.end(), body.begin(), body.end());
+	out.push_back(description.size());
+	out.insert(out.end(), description.begin(), description.end());
+}
+
+// --------------------------------------------------------- Constructors
+C3DWriter::C3DWriter(std::string fileName, const UuIcsC3d::C3dFileInfo & fileTemplate, float frameRate) :
+	_fileName(fileName),
+	_encoder(UuIcsC3d::get_basic_io(UuIcsC3d::Pt_Intel)),
+	_native(UuIcsC3d::platform_encoding() == UuIcsC3d::Pt_Intel),
+	_numPoints(fileTemplate.points_per_frame()),
+	_analogChannels(getTemplateAnalogChannels(fileTemplate)),
+	_analogSamples(fileTemplate.analog_samples_per_frame()),
+	_pointScale(std::fabs(fileTemplate.fi1().point_scale)),
+	_frameCount(0)
+{
+	if(_pointScale == 0)
+		_pointScale = 1.0;
+	if(frameRate <= 0)
+		frameRate = fileTemplate.content().header().frame_rate;
+
+	std::vector<unsigned char> header;
+	if(!writeHeader(fileTemplate, frameRate, header))
+	{
+		std::cerr << "C3D::C3DWriter::C3DWriter(): Template lacks POINT:USED, POINT:FRAMES or POINT:DATA_START, cannot write: " << fileName << std::endl;
+		return;
+	}
+
+	_file.open(fileName.c_str(), std::ios::binary | std::ios::trunc);
+	if(_file)
+		_file.write(reinterpret_cast<const char *>(header.data()), header.size());
+	if(!_file)
+	{
+		std::cerr << "C3D::C3DWriter::C3DWriter(): Cannot write to the file: " << fileName << std::endl;
+		_file.close();
+		return;
+	}
+	_buffer.reserve(BUFFER_BLOCKS * BLOCK_SIZE);
+}
+
+C3DWriter::~C3DWriter()
+{
+	close();
+}
+
+// --------------------------------------------------------- Public Functions
+bool C3DWriter::isOpen() const
+{
+	return _file.is_open();
+}
+
+uint C3DWriter::getFrameCount() const
+{
+	return _frameCount;
+}
+
+bool C3DWriter::writeFrame(const UuIcsC3d::FrameData & frame)
+{
+	if(!isOpen())
+		return false;
+
+	for(uint point = 0; point < _numPoints; point++)
+	{
+		if(point < frame.points.size())
+		{
+			const UuIcsC3d::DataPoint3d & dataPoint = frame.points[point];
+			appendPoint(dataPoint.coordinates(), dataPoint.status(), dataPoint.residual(), dataPoint.mask());
+		}
+		else
+			appendPoint(NULL, UuIcsC3d::DataPoint3d::Invalid, -1, 0);
+	}
+	for(uint sample = 0; sample < _analogSamples; sample++)
+		for(uint channel = 0; channel < _analogChannels; channel++)
+		{
+			bool present = channel < frame.analog_data.size() && sample < frame.analog_data[channel].size();
+			appendFloat(present ? frame.analog_data[channel][sample] : 0.0f);
+		}
+
+	_frameCount++;
+	return _buffer.size() < BUFFER_BLOCKS * BLOCK_SIZE || flushBlocks();
+}
+
+bool C3DWriter::writeFrames(const std::vector<UuIcsC3d::FrameData> & frames)
+{
+	for(uint i = 0; i < frames.size(); i++)
+		if(!writeFrame(frames[i]))
+			return false;
+	return true;
+}
+
+bool C3DWriter::writeFrames(const Marker::Trajectory & trajectory, uint firstFrame, uint numFrames)
+{
+	if(!isOpen())
+		return false;
+
+	for(uint frame = firstFrame; frame < firstFrame + numFrames && frame < trajectory.getNumFrames(); frame++)
+	{
+		for(uint point = 0; point < _numPoints; point++)
+		{
+			if(point < trajectory.getNumMarkers() && trajectory.isValid(frame, point))
+			{
+				Marker::Position position = trajectory.getPosition(frame, point);
+				float coordinates[3] = {position.x, position.y, position.z};
+				appendPoint(coordinates, trajectory.isGenerated(frame, point) ? UuIcsC3d::DataPoint3d::Generated : UuIcsC3d::DataPoint3d::Measured, 0, 0);
+			}
+			else
+				appendPoint(NULL, UuIcsC3d::DataPoint3d::Invalid, -1, 0);
+		}
+		for(uint value = 0; value < _analogSamples * _analogChannels; value++)
+			appendFloat(0.0f);
+
+		_frameCount++;
+		if(_buffer.size() >= BUFFER_BLOCKS * BLOCK_SIZE && !flushBlocks())
+			return false;
+	}
+	return true;
+}
+
+bool C3DWriter::close()
+{
+	if(!isOpen())
+		return false;
+
+	_buffer.resize((_buffer.size() + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE, 0);
+	bool success = flushBlocks();
+
+	// the 16-bit fields saturate, TRIAL:ACTUAL_END_FIELD holds the full count
+	unsigned char shortFrames[2];
+	_encoder->encode(shortFrames, static_cast<unsigned short>(std::min(_frameCount, MAX_SHORT_FRAMES)));
+	_file.seekp(LAST_FRAME_OFFSET);
+	_file.write(reinterpret_cast<const char *>(shortFrames), 2);
+	_file.seekp(_patchOffsets["POINT:FRAMES"]);
+	_file.write(reinterpret_cast<const char *>(shortFrames), 2);
+	if(_patchOffsets.count("TRIAL:ACTUAL_END_FIELD"))
+	{
+		unsigned char endField[4];
+		_encoder->encode(endField, static_cast<unsigned short>(_frameCount & 0xFFFF));
+		_encoder->encode(endField + 2, static_cast<unsigned short>(_frameCount >> 16));
+		_file.seekp(_patchOffsets["TRIAL:ACTUAL_END_FIELD"]);
+		_file.write(reinterpret_cast<const char *>(endField), 4);
+	}
+
+	success = success && _file.good();
+	_file.close();
+	if(DEBUG)
+		if(!success)
+			std::cout << "C3D::C3DWriter::close(): Cannot write to the file: " << _fileName << std::endl;
+	return success;
+}
+
+// --------------------------------------------------------- Private Functions
+void C3DWriter::appendPoint(const float * position, UuIcsC3d::DataPoint3d::Status status, float residual, unsigned char mask)
+{
+	if(status != UuIcsC3d::DataPoint3d::Measured && status != UuIcsC3d::DataPoint3d::Generated)
+	{
+		appendFloat(0.0f);
+		appendFloat(0.0f);
+		appendFloat(0.0f);
+		appendFloat(-1.0f);
+		return;
+	}
+
+	// camera mask in the high byte, residual divided by the scale in the low byte
+	// a zero residual marks a generated point, so a measured one is at least one unit
+	float scaledResidual = 0.0f;
+	if(status == UuIcsC3d::DataPoint3d::Measured)
+		scaledResidual = residual > 0 ? std::max(std::floor(residual / _pointScale + 0.5f), 1.0f) : 1.0f;
+	int residualWord = ((mask & 0x7F) << 8) | int(std::min(scaledResidual, 255.0f));
+	appendFloat(position[0]);
+	appendFloat(position[1]);
+	appendFloat(position[2]);
+	appendFloat(float(residualWord));
+}
+
+void C3DWriter::appendFloat(float value)
+{
+	std::size_t size = _buffer.size();
+	_buffer.resize(size + sizeof(float));
+	if(_native)
+		std::memcpy(&_buffer[size], &value, sizeof(float));
+	else
+		_encoder->encode(&_buffer[size], value);
+}
+
+bool C3DWriter::flushBlocks()
+{
+	std::size_t blocks = _buffer.size() / BLOCK_SIZE * BLOCK_SIZE;
+	_file.write(reinterpret_cast<const char *>(_buffer.data()), blocks);
+	_buffer.erase(_buffer.begin(), _buffer.begin() + blocks);
+	return _file.good();
+}
+
+bool C3DWriter::writeHeader(const UuIcsC3d::C3dFileInfo & fileTemplate, float frameRate, std::vector<unsigned char> & out)
+{
+	const UuIcsC3d::Content & content = fileTemplate.content();
+	boost::shared_ptr<UuIcsC3d::BasicIO> io = content.io();
+	const std::vector<UuIcsC3d::Group> & groups = content.the_groups();
+
+	// parameter section, re-encoded to Intel
+	std::vector<unsigned char> parameters(4, 0);
+	std::map<std::string, std::size_t> dataOffsets;
+	for(uint g = 0; g < groups.size(); g++)
+	{
+		int groupID = std::abs(groups[g].id());
+		appendItem(parameters, groups[g], -groupID, std::vector<unsigned char>(), *_encoder);
+
+		const std::vector<UuIcsC3d::Parameter> & groupParameters = groups[g].the_parameters();
+		for(uint p = 0; p < groupParameters.size(); p++)
+		{
+			const UuIcsC3d::Parameter & parameter = groupParameters[p];
+			std::vector<int> bounds = parameter.bounds();
+			std::vector<unsigned char> data = parameter.raw_data();
+			if(parameter.data_type() == UuIcsC3d::Parameter::DtShort)
+				for(uint i = 0; i + 2 <= data.size(); i += 2)
+					_encoder->encode(&data[i], io->to_int16(&data[i]));
+			else if(parameter.data_type() == UuIcsC3d::Parameter::DtFloat)
+				for(uint i = 0; i + 4 <= data.size(); i += 4)
+					_encoder->encode(&data[i], io->to_float(&data[i]));
+
+			std::vector<unsigned char> body;
+			body.push_back(static_cast<unsigned char>(static_cast<signed char>(parameter.data_type())));
+			body.push_back(bounds.size());
+			// bounds are kept slowest dimension first, the file stores them fastest first
+			for(uint i = bounds.size(); i > 0; i--)
+				body.push_back(bounds[i - 1]);
+			std::size_t itemStart = parameters.size();
+			body.insert(body.end(), data.begin(), data.end());
+			appendItem(parameters, parameter, groupID, body, *_encoder);
+
+			std::string name = parameter.name().substr(0, 127);
+			dataOffsets[groups[g].name() + ":" + parameter.name()] = itemStart + 2 + name.size() + 2 + 2 + bounds.size();
+		}
+	}
+	if(!dataOffsets.count("POINT:USED") || !dataOffsets.count("POINT:FRAMES") || !dataOffsets.count("POINT:DATA_START"))
+		return false;
+
+	uint parameterBlocks = (parameters.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	uint dataStart = 2 + parameterBlocks;
+	parameters.resize(parameterBlocks * BLOCK_SIZE, 0);
+	parameters[0] = 1;
+	parameters[1] = 0x50;
+	parameters[2] = parameterBlocks;
+	parameters[3] = UuIcsC3d::Pt_Intel;
+
+	_encoder->encode(&parameters[dataOffsets["POINT:USED"]], static_cast<unsigned short>(_numPoints));
+	_encoder->encode(&parameters[dataOffsets["POINT:FRAMES"]], static_cast<unsigned short>(0));
+	_encoder->encode(&parameters[dataOffsets["POINT:DATA_START"]], static_cast<unsigned short>(dataStart));
+	if(dataOffsets.count("POINT:SCALE"))
+		_encoder->encode(&parameters[dataOffsets["POINT:SCALE"]], -_pointScale);
+	if(dataOffsets.count("POINT:RATE"))
+		_encoder->encode(&parameters[dataOffsets["POINT:RATE"]], frameRate);
+	if(dataOffsets.count("TRIAL:ACTUAL_START_FIELD"))
+	{
+		_encoder->encode(&parameters[dataOffsets["TRIAL:ACTUAL_START_FIELD"]], static_cast<unsigned short>(1));
+		_encoder->encode(&parameters[dataOffsets["TRIAL:ACTUAL_START_FIELD"] + 2], static_cast<unsigned short>(0));
+	}
+	// patched by close() once the frame count is known, only if the template has the parameter
+	if(dataOffsets.count("TRIAL:ACTUAL_END_FIELD"))
+		_patchOffsets["TRIAL:ACTUAL_END_FIELD"] = PARAMETER_OFFSET + dataOffsets["TRIAL:ACTUAL_END_FIELD"];
+	_patchOffsets["POINT:FRAMES"] = PARAMETER_OFFSET + dataOffsets["POINT:FRAMES"];
+
+	// header block
+	const UuIcsC3d::Header & templateHeader = content.header();
+	out.assign(BLOCK_SIZE, 0);
+	out[0] = 2;
+	out[1] = 0x50;
+	_encoder->encode(&out[2], static_cast<unsigned short>(_numPoints));
+	_encoder->encode(&out[4], static_cast<unsigned short>(_analogChannels * _analogSamples));
+	_encoder->encode(&out[6], static_cast<unsigned short>(1));
+	_encoder->encode(&out[8], static_cast<unsigned short>(0));
+	_encoder->encode(&out[10], static_cast<unsigned short>(templateHeader.max_interpolation_gap));
+	_encoder->encode(&out[12], -_pointScale);
+	_encoder->encode(&out[16], static_cast<unsigned short>(dataStart));
+	_encoder->encode(&out[18], static_cast<unsigned short>(_analogSamples));
+	_encoder->encode(&out[20], frameRate);
+
+	out.insert(out.end(), parameters.begin(), parameters.end());
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+///
+/// \file DatasetCatalogue.cpp
+/// \brief Catalogue of the header data of the c3d files of the dataset
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "DatasetCatalogue.h"
+#include "MappedC3DFile.h"
+#include "ThreadPool.h"
+#include "StringFunc.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace C3D;
+
+static const char * CATALOGUE_COLUMNS = "subject\tsequence\tframes\tpoints\tframeRate\tanalogChannels\tanalogSamples\tlabels";
+
+// --------------------------------------------------------- Constructors
+DatasetCatalogue::DatasetCatalogue(uint numThreads) :
+	_numThreads(numThreads)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+uint DatasetCatalogue::scan(std::vector<SequenceKey> keys)
+{
+	std::sort(keys.begin(), keys.end());
+	_entries.clear();
+	for(uint i = 0; i < keys.size(); i++)
+		_entries.push_back(CatalogueEntry(keys[i], DatasetLoader::getFileName(keys[i])));
+
+	// every task owns one entry, no locking needed
+	{
+		ThreadPool pool(_numThreads);
+		for(uint i = 0; i < _entries.size(); i++)
+		{
+			CatalogueEntry * entry = &_entries[i];
+			pool.submit([entry]() { scanFile(*entry); });
+		}
+		pool.wait();
+	}
+
+	uint numFound = 0;
+	for(uint i = 0; i < _entries.size(); i++)
+		if(_entries[i].found)
+			numFound++;
+	return numFound;
+}
+
+uint DatasetCatalogue::scanAll()
+{
+	std::vector<SequenceKey> keys;
+	for(uint subjectNumber = 1; subjectNumber <= NUM_SUBJECTS; subjectNumber++)
+	{
+		std::vector<SequenceKey> subjectKeys = DatasetLoader::getSubjectKeys(subjectNumber);
+		keys.insert(keys.end(), subjectKeys.begin(), subjectKeys.end());
+	}
+	return scan(keys);
+}
+
+const std::vector<CatalogueEntry> & DatasetCatalogue::getEntries() const
+{
+	return _entries;
+}
+
+bool DatasetCatalogue::write(std::string fileName) const
+{
+	std::ofstream catalogueFileOut(fileName.c_str(), std::ios::trunc);
+	if(!catalogueFileOut)
+	{
+		if(DEBUG)
+			std::cout << "C3D::DatasetCatalogue::write(): Cannot write to the file: " << fileName << std::endl;
+		return false;
+	}
+
+	catalogueFileOut << CATALOGUE_COLUMNS << "\n";
+	for(uint i = 0; i < _entries.size(); i++)
+	{
+		const CatalogueEntry & entry = _entries[i];
+		if(!entry.found)
+			continue;
+		catalogueFileOut << entry.key.subject << "\t" << entry.key.sequence << "\t" << entry.frameCount << "\t" << entry.numPoints << "\t"
+			<< entry.frameRate << "\t" << entry.analogChannels << "\t" << entry.analogSamples << "\t";
+		for(uint point = 0; point < entry.pointLabels.size(); point++)
+			catalogueFileOut << (point ? "," : "") << entry.pointLabels[point];
+		catalogueFileOut << "\n";
+	}
+	return catalogueFileOut.good();
+}
+
+bool DatasetCatalogue::read(std::string fileName)
+{
+	std::ifstream catalogueFileIn(fileName.c_str());
+	std::string line;
+	if(!catalogueFileIn || !std::getline(catalogueFileIn, line) || line != CATALOGUE_COLUMNS)
+	{
+		std::cerr << "C3D::DatasetCatalogue::read(): Not a catalogue: " << fileName << std::endl;
+		return false;
+	}
+
+	_entries.clear();
+	while(std::getline(catalogueFileIn, line))
+	{
+		std::vector<std::string> columns;
+		std::istringstream lineIn(line);
+		std::string column;
+		while(std::getline(lineIn, column, '\t'))
+			columns.push_back(column);
+		if(columns.size() < 7)
+			continue;
+
+		SequenceKey key(stringToUInt(columns[0]), stringToUInt(columns[1]));
+		CatalogueEntry entry(key, DatasetLoader::getFileName(key));
+		entry.found = true;
+		entry.frameCount = stringToUInt(columns[2]);
+		entry.numPoints = stringToUInt(columns[3]);
+		entry.frameRate = std::atof(columns[4].c_str());
+		entry.analogChannels = stringToUInt(columns[5]);
+		entry.analogSamples = stringToUInt(columns[6]);
+		if(columns.size() > 7)
+		{
+			std::istringstream labelsIn(columns[7]);
+			std::string label;
+			while(std::getline(labelsIn, label, ','))
+				entry.pointLabels.push_back(label);
+		}
+		_entries.push_back(entry);
+	}
+	std::sort(_entries.begin(), _entries.end(), [](const CatalogueEntry & a, const CatalogueEntry & b) { return a.key < b.key; });
+	return true;
+}
+
+void DatasetCatalogue::scanFile(CatalogueEntry & entry)
+{
+	struct stat status;
+	if(stat(entry.fileName.c_str(), &status) != 0)
+		return;
+
+	try
+	{
+		// C3dFileInfo only reads the header block and the parameter section
+		UuIcsC3d::C3dFileInfo fileInfo(entry.fileName);
+		entry.frameCount = fileInfo.frame_count();
+		entry.numPoints = fileInfo.points_per_frame();
+		entry.frameRate = fileInfo.content().header().frame_rate;
+		entry.analogChannels = MappedC3DFile::getAnalogChannels(fileInfo);
+		entry.analogSamples = entry.analogChannels ? fileInfo.analog_samples_per_frame() : 0;
+		std::vector<UuIcsC3d::SpacePaddedString> labels = fileInfo.point_labels();
+		for(uint i = 0; i < labels.size() && i < entry.numPoints; i++)
+			entry.pointLabels.push_back(labels[i].stripped());
+		entry.found = true;
+	}
+	catch(UuIcsC3d::OpenError & e)
+	{
+		std::cerr << "C3D::DatasetCatalogue::scanFile(): Cannot open the file: " << e.filename() << std::endl;
+	}
+	catch(UuIcsC3d::ContentError & e)
+	{
+		std::cerr << "C3D::DatasetCatalogue::scanFile(): " << e.msg() << ": " << entry.fileName << std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+///
+/// \file DatasetLoader.cpp
+/// \brief Parallel loading of the c3d files of the dataset
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "DatasetLoader.h"
+#include "ThreadPool.h"
+#include "ReadAheadPipeline.h"
+#include "StringFunc.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+DatasetLoader::DatasetLoader(uint numThreads, uint maxInFlight) :
+	_reader(NUM_MARKERS, FRAME_RATE),
+	_numThreads(numThreads),
+	_maxInFlight(maxInFlight)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+C3DReader & DatasetLoader::getReader()
+{
+	return _reader;
+}
+
+std::map<SequenceKey, Marker::Trajectory> DatasetLoader::load(std::vector<SequenceKey> keys)
+{
+	std::map<SequenceKey, Marker::Trajectory> trajectories;
+	std::mutex resultLock;
+	_timings.clear();
+
+	{
+		ThreadPool pool(_numThreads, _maxInFlight);
+		for(uint i = 0; i < keys.size(); i++)
+		{
+			SequenceKey key = keys[i];
+			pool.submit([this, key, &trajectories, &resultLock]()
+			{
+				LoadTiming timing(key, getFileName(key));
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				Marker::Trajectory trajectory;
+				try
+				{
+					trajectory = _reader.readAllFrames(timing.fileName);
+					timing.loaded = trajectory.getNumFrames() > 0;
+				}
+				catch(UuIcsC3d::OpenError & e)
+				{
+					std::cerr << "C3D::DatasetLoader::load(): Cannot open the file: " << e.filename() << std::endl;
+				}
+				catch(UuIcsC3d::ContentError & e)
+				{
+					std::cerr << "C3D::DatasetLoader::load(): " << e.msg() << ": " << timing.fileName << std::endl;
+				}
+				timing.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				timing.numFrames = trajectory.getNumFrames();
+
+				std::lock_guard<std::mutex> lock(resultLock);
+				if(timing.loaded)
+					trajectories[key] = std::move(trajectory);
+				_timings.push_back(timing);
+			});
+		}
+		pool.wait();
+	}
+
+	std::sort(_timings.begin(), _timings.end(), [](const LoadTiming & a, const LoadTiming & b) { return a.key < b.key; });
+	return trajectories;
+}
+
+std::map<SequenceKey, Marker::Trajectory> DatasetLoader::loadSubject(uint subjectNumber)
+{
+	return load(getSubjectKeys(subjectNumber));
+}
+
+std::map<SequenceKey, Marker::Trajectory> DatasetLoader::loadAll()
+{
+	std::vector<SequenceKey> keys;
+	for(uint subjectNumber = 1; subjectNumber <= NUM_SUBJECTS; subjectNumber++)
+	{
+		std::vector<SequenceKey> subjectKeys = getSubjectKeys(subjectNumber);
+		keys.insert(keys.end(), subjectKeys.begin(), subjectKeys.end());
+	}
+	return load(keys);
+}
+
+uint DatasetLoader::process(std::vector<SequenceKey> keys, std::function<void(SequenceKey, Marker::Trajectory &)> processor, uint depth)
+{
+	uint numProcessed = 0;
+	ReadAheadPipeline pipeline(_reader, keys, depth, _numThreads);
+	SequenceKey key(0, 0);
+	Marker::Trajectory trajectory;
+	while(pipeline.next(key, trajectory))
+	{
+		processor(key, trajectory);
+		numProcessed++;
+	}
+	_timings = pipeline.getTimings();
+	return numProcessed;
+}
+
+const std::vector<LoadTiming> & DatasetLoader::getTimings() const
+{
+	return _timings;
+}
+
+std::string DatasetLoader::getFileName(SequenceKey key)
+{
+	std::string c3dDirectory = "..//data//c3d//" + intToString(key.subject);
+	switch(key.sequence)
+	{
+	case CALIBRATION_BODY:
+		return c3dDirectory + "//Body.c3d";
+	case CALIBRATION_LEFT:
+		return c3dDirectory + "//Left.c3d";
+	case CALIBRATION_RIGHT:
+		return c3dDirectory + "//Right.c3d";
+	default:
+		return c3dDirectory + "//" + intToString(key.sequence) + ".c3d";
+	}
+}
+
+std::vector<SequenceKey> DatasetLoader::getSubjectKeys(uint subjectNumber)
+{
+	std::vector<SequenceKey> keys;
+	for(uint sequenceNumber = 1; sequenceNumber <= NUM_SEQUENCES; sequenceNumber++)
+		keys.push_back(SequenceKey(subjectNumber, sequenceNumber));
+	keys.push_back(SequenceKey(subjectNumber, CALIBRATION_BODY));
+	keys.push_back(SequenceKey(subjectNumber, CALIBRATION_LEFT));
+	keys.push_back(SequenceKey(subjectNumber, CALIBRATION_RIGHT));
+	return keys;
+}
\ No newline at end of file
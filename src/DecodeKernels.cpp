@@ -0,0 +1,332 @@
+///
+/// \file DecodeKernels.cpp
+/// \brief Bulk conversion of the point words of c3d frames
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "DecodeKernels.h"
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DECODE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace C3D;
+
+// A point is decoded in two passes over a chunk: the raw words are first
+// widened to native floats (byte order, VAX format, 16-bit integers), then
+// the quads are split into x y z and the residual.
+
+typedef void (*WidenShortsKernel)(const unsigned char * in, uint numWords, bool swap, float * out);
+typedef void (*ConvertFloatsKernel)(const unsigned char * in, uint numWords, UuIcsC3d::EncodingType encoding, float * out);
+typedef void (*SplitQuadsKernel)(const unsigned char * quads, uint numPoints, float coordinateScale, float residualScale, float * positions, float * residuals);
+
+///
+/// \struct Kernels
+/// \brief one implementation of each pass
+///
+struct Kernels
+{
+	InstructionSet			instructionSet;
+	WidenShortsKernel		widenShorts;
+	ConvertFloatsKernel		convertFloats;
+	SplitQuadsKernel		splitQuads;
+};
+
+static const uint32_t VAX_EXPONENT_MASK = 0x7F800000;
+static const float VAX_SCALE = 0.25f;					///< VAX F has a bias of 128 and a hidden 0.1 mantissa
+
+// --------------------------------------------------------- Scalar kernels
+static void widenShortsScalar(const unsigned char * in, uint numWords, bool swap, float * out)
+{
+	for(uint i = 0; i < numWords; i++)
+	{
+		uint16_t word;
+		std::memcpy(&word, in + 2 * i, sizeof(word));
+		if(swap)
+			word = uint16_t((word >> 8) | (word << 8));
+		out[i] = int16_t(word);
+	}
+}
+
+static void convertFloatsScalar(const unsigned char * in, uint numWords, UuIcsC3d::EncodingType encoding, float * out)
+{
+	for(uint i = 0; i < numWords; i++)
+	{
+		uint32_t word;
+		std::memcpy(&word, in + 4 * i, sizeof(word));
+		if(encoding == UuIcsC3d::Pt_Mips)
+			word = (word >> 24) | ((word >> 8) & 0xFF00) | ((word << 8) & 0xFF0000) | (word << 24);
+		else if(encoding == UuIcsC3d::Pt_Dec)
+			word = (word >> 16) | (word << 16);
+		std::memcpy(&out[i], &word, sizeof(word));
+		if(encoding == UuIcsC3d::Pt_Dec)
+			out[i] = (word & VAX_EXPONENT_MASK) ? out[i] * VAX_SCALE : 0.0f;
+	}
+}
+
+static void splitQuadsScalar(const unsigned char * quads, uint numPoints, float coordinateScale, float residualScale, float * positions, float * residuals)
+{
+	for(uint point = 0; point < numPoints; point++)
+	{
+		float words[4];
+		std::memcpy(words, quads + 16 * point, sizeof(words));
+		positions[3 * point] = words[0] * coordinateScale;
+		positions[3 * point + 1] = words[1] * coordinateScale;
+		positions[3 * point + 2] = words[2] * coordinateScale;
+		if(residuals)
+			residuals[point] = words[3] >= 0 ? (int(words[3]) & 0xFF) * residualScale : -1.0f;
+	}
+}
+
+#ifdef DECODE_KERNELS_X86
+// --------------------------------------------------------- SSE4.1 kernels
+__attribute__((target("ssse3,sse4.1")))
+static void widenShortsSSE41(const unsigned char * in, uint numWords, bool swap, float * out)
+{
+	const __m128i swapMask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	uint i = 0;
+	for(; i + 8 <= numWords; i += 8)
+	{
+		__m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i));
+		if(swap)
+			words = _mm_shuffle_epi8(words, swapMask);
+		_mm_storeu_ps(out + i, _mm_cvtepi32_ps(_mm_cvtepi16_epi32(words)));
+		_mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(words, 8))));
+	}
+	widenShortsScalar(in + 2 * i, numWords - i, swap, out + i);
+}
+
+__attribute__((target("ssse3,sse4.1")))
+static void convertFloatsSSE41(const unsigned char * in, uint numWords, UuIcsC3d::EncodingType encoding, float * out)
+{
+	const __m128i mask = encoding == UuIcsC3d::Pt_Mips
+		? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+		: _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+	const __m128i exponentMask = _mm_set1_epi32(VAX_EXPONENT_MASK);
+	const __m128 scale = _mm_set1_ps(VAX_SCALE);
+	uint i = 0;
+	for(; i + 4 <= numWords; i += 4)
+	{
+		__m128i words = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4 * i)), mask);
+		__m128 values = _mm_castsi128_ps(words);
+		if(encoding == UuIcsC3d::Pt_Dec)
+		{
+			__m128 zero = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(words, exponentMask), _mm_setzero_si128()));
+			values = _mm_andnot_ps(zero, _mm_mul_ps(values, scale));
+		}
+		_mm_storeu_ps(out + i, values);
+	}
+	convertFloatsScalar(in + 4 * i, numWords - i, encoding, out + i);
+}
+
+__attribute__((target("ssse3,sse4.1")))
+static void splitQuadsSSE41(const unsigned char * quads, uint numPoints, float coordinateScale, float residualScale, float * positions, float * residuals)
+{
+	const __m128 coordinates = _mm_set1_ps(coordinateScale);
+	const __m128 scale = _mm_set1_ps(residualScale);
+	const __m128i lowByte = _mm_set1_epi32(0xFF);
+	uint point = 0;
+	for(; point + 4 <= numPoints; point += 4)
+	{
+		const float * in = reinterpret_cast<const float *>(quads + 16 * point);
+		__m128 q0 = _mm_loadu_ps(in);
+		__m128 q1 = _mm_loadu_ps(in + 4);
+		__m128 q2 = _mm_loadu_ps(in + 8);
+		__m128 q3 = _mm_loadu_ps(in + 12);
+
+		// overlapping stores, the fourth lane is overwritten by the next point
+		float * out = positions + 3 * point;
+		_mm_storeu_ps(out, _mm_mul_ps(q0, coordinates));
+		_mm_storeu_ps(out + 3, _mm_mul_ps(q1, coordinates));
+		_mm_storeu_ps(out + 6, _mm_mul_ps(q2, coordinates));
+		__m128 last = _mm_mul_ps(q3, coordinates);
+		_mm_storel_pi(reinterpret_cast<__m64 *>(out + 9), last);
+		_mm_store_ss(out + 11, _mm_movehl_ps(last, last));
+
+		if(residuals)
+		{
+			__m128 words = _mm_movehl_ps(_mm_unpackhi_ps(q2, q3), _mm_unpackhi_ps(q0, q1));
+			__m128 values = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_cvttps_epi32(words), lowByte)), scale);
+			_mm_storeu_ps(residuals + point, _mm_blendv_ps(_mm_set1_ps(-1.0f), values, _mm_cmpge_ps(words, _mm_setzero_ps())));
+		}
+	}
+	splitQuadsScalar(quads + 16 * point, numPoints - point, coordinateScale, residualScale, positions + 3 * point, residuals ? residuals + point : NULL);
+}
+
+// --------------------------------------------------------- AVX2 kernels
+__attribute__((target("avx2")))
+static void widenShortsAVX2(const unsigned char * in, uint numWords, bool swap, float * out)
+{
+	const __m256i swapMask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+		1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	uint i = 0;
+	for(; i + 16 <= numWords; i += 16)
+	{
+		__m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 2 * i));
+		if(swap)
+			words = _mm256_shuffle_epi8(words, swapMask);
+		_mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(words))));
+		_mm256_storeu_ps(out + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(words, 1))));
+	}
+	_mm256_zeroupper();
+	widenShortsScalar(in + 2 * i, numWords - i, swap, out + i);
+}
+
+__attribute__((target("avx2")))
+static void convertFloatsAVX2(const unsigned char * in, uint numWords, UuIcsC3d::EncodingType encoding, float * out)
+{
+	const __m256i mask = encoding == UuIcsC3d::Pt_Mips
+		? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+		: _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+			2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+	const __m256i exponentMask = _mm256_set1_epi32(VAX_EXPONENT_MASK);
+	const __m256 scale = _mm256_set1_ps(VAX_SCALE);
+	uint i = 0;
+	for(; i + 8 <= numWords; i += 8)
+	{
+		__m256i words = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 4 * i)), mask);
+		__m256 values = _mm256_castsi256_ps(words);
+		if(encoding == UuIcsC3d::Pt_Dec)
+		{
+			__m256 zero = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(words, exponentMask), _mm256_setzero_si256()));
+			values = _mm256_andnot_ps(zero, _mm256_mul_ps(values, scale));
+		}
+		_mm256_storeu_ps(out + i, values);
+	}
+	_mm256_zeroupper();
+	convertFloatsScalar(in + 4 * i, numWords - i, encoding, out + i);
+}
+
+__attribute__((target("avx2")))
+static void splitQuadsAVX2(const unsigned char * quads, uint numPoints, float coordinateScale, float residualScale, float * positions, float * residuals)
+{
+	const __m256 coordinates = _mm256_set1_ps(coordinateScale);
+	const __m256 scale = _mm256_set1_ps(residualScale);
+	const __m256i lowByte = _mm256_set1_epi32(0xFF);
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	uint point = 0;
+	for(; point + 8 <= numPoints; point += 8)
+	{
+		// two points per register: (p0 p1) (p2 p3) (p4 p5) (p6 p7)
+		const float * in = reinterpret_cast<const float *>(quads + 16 * point);
+		__m256 a = _mm256_loadu_ps(in);
+		__m256 b = _mm256_loadu_ps(in + 8);
+		__m256 c = _mm256_loadu_ps(in + 16);
+		__m256 d = _mm256_loadu_ps(in + 24);
+
+		// overlapping stores, the fourth lane is overwritten by the next point
+		__m256 scaled[4] = {_mm256_mul_ps(a, coordinates), _mm256_mul_ps(b, coordinates), _mm256_mul_ps(c, coordinates), _mm256_mul_ps(d, coordinates)};
+		float * out = positions + 3 * point;
+		for(uint k = 0; k < 4; k++)
+		{
+			_mm_storeu_ps(out + 6 * k, _mm256_castps256_ps128(scaled[k]));
+			if(k < 3)
+				_mm_storeu_ps(out + 6 * k + 3, _mm256_extractf128_ps(scaled[k], 1));
+		}
+		__m128 last = _mm256_extractf128_ps(scaled[3], 1);
+		_mm_storel_pi(reinterpret_cast<__m64 *>(out + 21), last);
+		_mm_store_ss(out + 23, _mm_movehl_ps(last, last));
+
+		if(residuals)
+		{
+			// (p0 p2 p4 p6 | p1 p3 p5 p7) fourth words, then back in point order
+			__m256 words = _mm256_shuffle_ps(_mm256_unpackhi_ps(a, b), _mm256_unpackhi_ps(c, d), _MM_SHUFFLE(3, 2, 3, 2));
+			words = _mm256_permutevar8x32_ps(words, order);
+			__m256 values = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_cvttps_epi32(words), lowByte)), scale);
+			__m256 valid = _mm256_cmp_ps(words, _mm256_setzero_ps(), _CMP_GE_OQ);
+			_mm256_storeu_ps(residuals + point, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), values, valid));
+		}
+	}
+	// leave the upper halves clean before running legacy SSE code
+	_mm256_zeroupper();
+	splitQuadsSSE41(quads + 16 * point, numPoints - point, coordinateScale, residualScale, positions + 3 * point, residuals ? residuals + point : NULL);
+}
+#endif
+
+///
+/// \brief kernels of an instruction set, lowered to what the CPU supports
+///
+static Kernels selectKernels(InstructionSet requested)
+{
+	Kernels kernels = {ISA_SCALAR, widenShortsScalar, convertFloatsScalar, splitQuadsScalar};
+#ifdef DECODE_KERNELS_X86
+	__builtin_cpu_init();
+	bool hasSSE41 = __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+	if(requested >= ISA_AVX2 && hasSSE41 && __builtin_cpu_supports("avx2"))
+	{
+		Kernels avx2 = {ISA_AVX2, widenShortsAVX2, convertFloatsAVX2, splitQuadsAVX2};
+		kernels = avx2;
+	}
+	else if(requested >= ISA_SSE41 && hasSSE41)
+	{
+		Kernels sse41 = {ISA_SSE41, widenShortsSSE41, convertFloatsSSE41, splitQuadsSSE41};
+		kernels = sse41;
+	}
+#else
+	(void)requested;
+#endif
+	return kernels;
+}
+
+///
+/// \brief kernels in use, the best available on first use
+///
+static Kernels & activeKernels()
+{
+	static Kernels kernels = selectKernels(ISA_AVX2);
+	return kernels;
+}
+
+// --------------------------------------------------------- Public Functions
+InstructionSet C3D::getInstructionSet()
+{
+	return activeKernels().instructionSet;
+}
+
+InstructionSet C3D::setInstructionSet(InstructionSet instructionSet)
+{
+	activeKernels() = selectKernels(instructionSet);
+	return activeKernels().instructionSet;
+}
+
+void C3D::decodePoints(const unsigned char * in, uint numPoints, bool isInteger, UuIcsC3d::EncodingType encoding, float pointScale, float * positions, float * residuals)
+{
+	const Kernels & kernels = activeKernels();
+	const uint pointSize = isInteger ? 8 : 16;
+	float scratch[4 * DECODE_CHUNK_POINTS];
+
+	while(numPoints > 0)
+	{
+		uint chunk = numPoints < DECODE_CHUNK_POINTS ? numPoints : DECODE_CHUNK_POINTS;
+		const unsigned char * quads = reinterpret_cast<const unsigned char *>(scratch);
+		if(isInteger)
+			kernels.widenShorts(in, 4 * chunk, encoding == UuIcsC3d::Pt_Mips, scratch);
+		else if(encoding != UuIcsC3d::Pt_Intel)
+			kernels.convertFloats(in, 4 * chunk, encoding, scratch);
+		else
+			quads = in;
+		kernels.splitQuads(quads, chunk, isInteger ? pointScale : 1.0f, pointScale, positions, residuals);
+
+		in += chunk * pointSize;
+		positions += 3 * chunk;
+		if(residuals)
+			residuals += chunk;
+		numPoints -= chunk;
+	}
+}
+
+void C3D::decodeWords(const unsigned char * in, uint numWords, bool isInteger, UuIcsC3d::EncodingType encoding, float * out)
+{
+	const Kernels & kernels = activeKernels();
+	if(isInteger)
+		kernels.widenShorts(in, numWords, encoding == UuIcsC3d::Pt_Mips, out);
+	else if(encoding != UuIcsC3d::Pt_Intel)
+		kernels.convertFloats(in, numWords, encoding, out);
+	else
+		std::memcpy(out, in, std::size_t(numWords) * sizeof(float));
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+///
+/// \file FrameCursor.cpp
+/// \brief Frame by frame reading of a c3d file
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "FrameCursor.h"
+#include <iostream>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+FrameCursor::FrameCursor(std::string fileName) :
+	_fileInfo(fileName),
+	_file(_fileInfo.open().release()),
+	_firstFrame(0),
+	_lastFrame(0),
+	_frame(0),
+	_loaded(false)
+{
+	setFrameRange(0, getFrameCount());
+}
+
+FrameCursor::FrameCursor(std::string fileName, uint firstFrame, uint lastFrame) :
+	_fileInfo(fileName),
+	_file(_fileInfo.open().release()),
+	_firstFrame(0),
+	_lastFrame(0),
+	_frame(0),
+	_loaded(false)
+{
+	setFrameRange(firstFrame, lastFrame);
+}
+
+// --------------------------------------------------------- Public Functions
+void FrameCursor::setFrameRange(uint firstFrame, uint lastFrame)
+{
+	if(lastFrame > getFrameCount())
+		lastFrame = getFrameCount();
+	if(firstFrame > lastFrame)
+	{
+		std::cerr << "C3D::FrameCursor::setFrameRange(): Empty range [" << firstFrame << ", " << lastFrame << ")" << std::endl;
+		firstFrame = lastFrame;
+	}
+	_firstFrame = firstFrame;
+	_lastFrame = lastFrame;
+	_frame = firstFrame;
+	_loaded = false;
+}
+
+bool FrameCursor::next()
+{
+	uint frame = _loaded ? _frame + 1 : _frame;
+	return seek(frame);
+}
+
+bool FrameCursor::seek(uint frame)
+{
+	if(frame < _firstFrame || frame >= _lastFrame)
+		return false;
+	_file->get_frame_data(_frameData, frame);
+	_frame = frame;
+	_loaded = true;
+	return true;
+}
+
+uint FrameCursor::getFrame() const
+{
+	return _frame;
+}
+
+uint FrameCursor::getFrameCount() const
+{
+	return _fileInfo.frame_count();
+}
+
+const UuIcsC3d::FrameData & FrameCursor::getFrameData() const
+{
+	return _frameData;
+}
+
+Marker::Position FrameCursor::getPosition(uint marker) const
+{
+	const UuIcsC3d::DataPoint3d & point = _frameData.points[marker];
+	Marker::Position position = {point.x(), point.y(), point.z()};
+	return position;
+}
+
+bool FrameCursor::isValid(uint marker) const
+{
+	return _frameData.points[marker].is_valid();
+}
\ No newline at end of file
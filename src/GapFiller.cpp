@@ -0,0 +1,343 @@
+///
+/// \file GapFiller.cpp
+/// \brief Filling of the gaps of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "GapFiller.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+using namespace C3D;
+
+static const double MIN_FRAME_AREA = 1e-6;		///< squared sine below which three markers are taken as collinear
+
+///
+/// \struct RigidFrame
+/// \brief Orthonormal frame attached to three markers of a foot
+///
+struct RigidFrame
+{
+	double		origin[3];			///< centroid of the markers
+	double		axes[3][3];			///< first marker to second, in plane normal to it, normal to the plane
+};
+
+// --------------------------------------------------------- Static Functions
+///
+/// \brief attach a frame to three markers
+///	\param markers: three positions
+///	\param frame: frame built
+///	\return false if the markers are collinear
+///
+static bool makeFrame(const Marker::Position * markers, RigidFrame & frame)
+{
+	double p[3][3];
+	for(uint i = 0; i < 3; i++)
+	{
+		p[i][0] = markers[i].x;
+		p[i][1] = markers[i].y;
+		p[i][2] = markers[i].z;
+	}
+	double u[3], v[3];
+	for(uint axis = 0; axis < 3; axis++)
+	{
+		frame.origin[axis] = (p[0][axis] + p[1][axis] + p[2][axis]) / 3;
+		u[axis] = p[1][axis] - p[0][axis];
+		v[axis] = p[2][axis] - p[0][axis];
+	}
+	double * e1 = frame.axes[0];
+	double * e2 = frame.axes[1];
+	double * e3 = frame.axes[2];
+	e3[0] = u[1] * v[2] - u[2] * v[1];
+	e3[1] = u[2] * v[0] - u[0] * v[2];
+	e3[2] = u[0] * v[1] - u[1] * v[0];
+	double uu = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+	double vv = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+	double nn = e3[0] * e3[0] + e3[1] * e3[1] + e3[2] * e3[2];
+	if(!(nn > MIN_FRAME_AREA * uu * vv))
+		return false;
+	for(uint axis = 0; axis < 3; axis++)
+	{
+		e1[axis] = u[axis] / std::sqrt(uu);
+		e3[axis] /= std::sqrt(nn);
+	}
+	e2[0] = e3[1] * e1[2] - e3[2] * e1[1];
+	e2[1] = e3[2] * e1[0] - e3[0] * e1[2];
+	e2[2] = e3[0] * e1[1] - e3[1] * e1[0];
+	return true;
+}
+
+///
+/// \brief express a position in a frame
+///	\param frame: rigid frame
+///	\param position: global position
+///	\param local: coordinates along the axes of the frame
+///
+static void toLocal(const RigidFrame & frame, const Marker::Position & position, double * local)
+{
+	double d[3] = {position.x - frame.origin[0], position.y - frame.origin[1], position.z - frame.origin[2]};
+	for(uint i = 0; i < 3; i++)
+		local[i] = d[0] * frame.axes[i][0] + d[1] * frame.axes[i][1] + d[2] * frame.axes[i][2];
+}
+
+///
+/// \brief move local coordinates back to global
+///	\param frame: rigid frame
+///	\param local: coordinates along the axes of the frame
+///	\param global: global position
+///
+static void toGlobal(const RigidFrame & frame, const double * local, double * global)
+{
+	for(uint axis = 0; axis < 3; axis++)
+		global[axis] = frame.origin[axis] + local[0] * frame.axes[0][axis] + local[1] * frame.axes[1][axis] + local[2] * frame.axes[2][axis];
+}
+
+// --------------------------------------------------------- Constructors
+GapFiller::GapFiller(GapFillMethod method, uint maxGap, const MarkerLayout & layout, uint numThreads) :
+	_layout(layout),
+	_method(method),
+	_maxGap(maxGap),
+	_numThreads(numThreads)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+uint GapFiller::fill(Marker::Trajectory & trajectory) const
+{
+	Marker::ValidityIndex validity(trajectory);
+	std::vector<uint> numFilled(trajectory.getNumMarkers(), 0);
+	{
+		ThreadPool pool(_numThreads);
+		for(uint marker = 0; marker < trajectory.getNumMarkers(); marker++)
+		{
+			Marker::Trajectory * markerTrajectory = &trajectory;
+			uint * markerFilled = &numFilled[marker];
+			pool.submit([this, markerTrajectory, &validity, marker, markerFilled]() { *markerFilled = fillMarker(*markerTrajectory, validity, marker); });
+		}
+		pool.wait();
+	}
+
+	uint total = 0;
+	for(uint marker = 0; marker < numFilled.size(); marker++)
+		total += numFilled[marker];
+	return total;
+}
+
+uint GapFiller::fillAll(std::map<SequenceKey, Marker::Trajectory> & trajectories) const
+{
+	// every task owns one index, then one marker of one trajectory
+	std::vector<Marker::Trajectory *> sequences;
+	for(std::map<SequenceKey, Marker::Trajectory>::iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		sequences.push_back(&it->second);
+	std::vector<Marker::ValidityIndex> indices(sequences.size());
+	std::vector<std::vector<uint> > numFilled(sequences.size());
+	{
+		ThreadPool pool(_numThreads);
+		for(uint sequence = 0; sequence < sequences.size(); sequence++)
+		{
+			Marker::Trajectory * trajectory = sequences[sequence];
+			Marker::ValidityIndex * validity = &indices[sequence];
+			numFilled[sequence].resize(trajectory->getNumMarkers(), 0);
+			pool.submit([trajectory, validity]() { validity->build(*trajectory); });
+		}
+		pool.wait();
+
+		for(uint sequence = 0; sequence < sequences.size(); sequence++)
+		{
+			Marker::Trajectory * trajectory = sequences[sequence];
+			const Marker::ValidityIndex * validity = &indices[sequence];
+			for(uint marker = 0; marker < trajectory->getNumMarkers(); marker++)
+			{
+				uint * markerFilled = &numFilled[sequence][marker];
+				pool.submit([this, trajectory, validity, marker, markerFilled]() { *markerFilled = fillMarker(*trajectory, *validity, marker); });
+			}
+		}
+		pool.wait();
+	}
+
+	uint total = 0;
+	for(uint sequence = 0; sequence < numFilled.size(); sequence++)
+		for(uint marker = 0; marker < numFilled[sequence].size(); marker++)
+			total += numFilled[sequence][marker];
+	return total;
+}
+
+uint GapFiller::fillMarker(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, uint marker) const
+{
+	// a foot marker of the layout can be rebuilt from the rest of its foot
+	bool onFoot = false;
+	BodyParts foot = LEFT_FOOT;
+	uint element = 0;
+	if(_method == GAP_FILL_RIGID_BODY && _layout.getNumMarkers() == trajectory.getNumMarkers())
+		for(uint part = LEFT_FOOT; part <= RIGHT_FOOT; part++)
+			for(uint i = 0; i < NUM_FOOT_MARKERS; i++)
+				if(_layout.getIndex(BodyParts(part), i) == marker)
+				{
+					onFoot = true;
+					foot = BodyParts(part);
+					element = i;
+				}
+
+	uint numFrames = trajectory.getNumFrames();
+	uint numFilled = 0;
+	std::vector<Marker::FrameRun> gaps = validity.getGaps(marker, 0, numFrames);
+	for(uint i = 0; i < gaps.size(); i++)
+	{
+		const Marker::FrameRun & gap = gaps[i];
+		if(gap.length > _maxGap)
+			continue;
+		if(!onFoot || !fillRigidBody(trajectory, validity, foot, element, gap))
+		{
+			if(gap.first == 0 || gap.end() >= numFrames)
+				continue;
+			if(_method == GAP_FILL_LINEAR)
+				fillLinear(trajectory, marker, gap);
+			else
+				fillSpline(trajectory, validity, marker, gap);
+		}
+		numFilled += gap.length;
+	}
+	return numFilled;
+}
+
+// --------------------------------------------------------- Private Functions
+void GapFiller::fillLinear(Marker::Trajectory & trajectory, uint marker, const Marker::FrameRun & gap) const
+{
+	uint before = gap.first - 1;
+	uint after = gap.end();
+	Marker::Position first = trajectory.getPosition(before, marker);
+	Marker::Position last = trajectory.getPosition(after, marker);
+	for(uint frame = gap.first; frame < after; frame++)
+	{
+		float t = float(frame - before) / (after - before);
+		Marker::Position position = {first.x + t * (last.x - first.x), first.y + t * (last.y - first.y), first.z + t * (last.z - first.z)};
+		trajectory.setPosition(frame, marker, position, true);
+	}
+}
+
+void GapFiller::fillSpline(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, uint marker, const Marker::FrameRun & gap) const
+{
+	// knots: the measured frames next to the gap, up to the neighbouring gaps
+	const uint maxKnots = 2 * GAP_SPLINE_SUPPORT;
+	double t[maxKnots];
+	double y[Marker::NUM_AXES][maxKnots];
+	uint numBefore = 0;
+	for(uint frame = gap.first; frame-- > 0 && numBefore < GAP_SPLINE_SUPPORT && validity.isValid(marker, frame, frame + 1); )
+		numBefore++;
+	uint numAfter = 0;
+	for(uint frame = gap.end(); frame < trajectory.getNumFrames() && numAfter < GAP_SPLINE_SUPPORT && validity.isValid(marker, frame, frame + 1); frame++)
+		numAfter++;
+	uint numKnots = numBefore + numAfter;
+	for(uint knot = 0; knot < numKnots; knot++)
+	{
+		uint frame = knot < numBefore ? gap.first - numBefore + knot : gap.end() + knot - numBefore;
+		Marker::Position position = trajectory.getPosition(frame, marker);
+		t[knot] = frame;
+		y[Marker::AXIS_X][knot] = position.x;
+		y[Marker::AXIS_Y][knot] = position.y;
+		y[Marker::AXIS_Z][knot] = position.z;
+	}
+
+	// second derivatives, zero at both ends, by elimination of the tridiagonal system shared by the three axes
+	double h[maxKnots];
+	double diagonal[maxKnots];
+	double m[Marker::NUM_AXES][maxKnots];
+	for(uint knot = 0; knot + 1 < numKnots; knot++)
+		h[knot] = t[knot + 1] - t[knot];
+	for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+		m[axis][0] = m[axis][numKnots - 1] = 0;
+	for(uint knot = 1; knot + 1 < numKnots; knot++)
+	{
+		diagonal[knot] = 2 * (h[knot - 1] + h[knot]);
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			m[axis][knot] = 6 * ((y[axis][knot + 1] - y[axis][knot]) / h[knot] - (y[axis][knot] - y[axis][knot - 1]) / h[knot - 1]);
+		if(knot > 1)
+		{
+			double factor = h[knot - 1] / diagonal[knot - 1];
+			diagonal[knot] -= factor * h[knot - 1];
+			for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+				m[axis][knot] -= factor * m[axis][knot - 1];
+		}
+	}
+	for(uint knot = numKnots - 1; knot-- > 1; )
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			m[axis][knot] = (m[axis][knot] - h[knot] * m[axis][knot + 1]) / diagonal[knot];
+
+	// the gap lies between the last knot before it and the first after it
+	uint j = numBefore - 1;
+	double span = h[j];
+	for(uint frame = gap.first; frame < gap.end(); frame++)
+	{
+		double a = t[j + 1] - frame;
+		double b = frame - t[j];
+		float value[Marker::NUM_AXES];
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			value[axis] = float((m[axis][j] * a * a * a + m[axis][j + 1] * b * b * b) / (6 * span)
+				+ (y[axis][j] / span - m[axis][j] * span / 6) * a + (y[axis][j + 1] / span - m[axis][j + 1] * span / 6) * b);
+		Marker::Position position = {value[Marker::AXIS_X], value[Marker::AXIS_Y], value[Marker::AXIS_Z]};
+		trajectory.setPosition(frame, marker, position, true);
+	}
+}
+
+bool GapFiller::fillRigidBody(Marker::Trajectory & trajectory, const Marker::ValidityIndex & validity, BodyParts foot, uint element, const Marker::FrameRun & gap) const
+{
+	uint marker = _layout.getIndex(foot, element);
+	uint others[NUM_FOOT_MARKERS - 1];
+	for(uint i = 0, n = 0; i < NUM_FOOT_MARKERS; i++)
+		if(i != element)
+			others[n++] = _layout.getIndex(foot, i);
+	for(uint i = 0; i < NUM_FOOT_MARKERS - 1; i++)
+		if(!validity.isValid(others[i], gap.first, gap.end()))
+			return false;
+
+	// the marker in the frame of the rest of the foot, on each side of the gap where the whole foot is measured
+	uint references[2] = {gap.first - 1, gap.end()};
+	bool hasReference[2] = {gap.first > 0, gap.end() < trajectory.getNumFrames()};
+	double local[2][3];
+	for(uint side = 0; side < 2; side++)
+	{
+		if(!hasReference[side])
+			continue;
+		uint frame = references[side];
+		Marker::Position positions[NUM_FOOT_MARKERS - 1];
+		for(uint i = 0; i < NUM_FOOT_MARKERS - 1; i++)
+		{
+			hasReference[side] = hasReference[side] && validity.isValid(others[i], frame, frame + 1);
+			positions[i] = trajectory.getPosition(frame, others[i]);
+		}
+		RigidFrame rigidFrame;
+		hasReference[side] = hasReference[side] && makeFrame(positions, rigidFrame);
+		if(hasReference[side])
+			toLocal(rigidFrame, trajectory.getPosition(frame, marker), local[side]);
+	}
+	if(!hasReference[0] && !hasReference[1])
+		return false;
+
+	// the rest of the foot is measured, but could still be degenerate inside the gap
+	std::vector<RigidFrame> rigidFrames(gap.length);
+	for(uint frame = gap.first; frame < gap.end(); frame++)
+	{
+		Marker::Position positions[NUM_FOOT_MARKERS - 1];
+		for(uint i = 0; i < NUM_FOOT_MARKERS - 1; i++)
+			positions[i] = trajectory.getPosition(frame, others[i]);
+		if(!makeFrame(positions, rigidFrames[frame - gap.first]))
+			return false;
+	}
+
+	// blend the two rebuilt positions across the gap
+	for(uint frame = gap.first; frame < gap.end(); frame++)
+	{
+		double global[2][3];
+		for(uint side = 0; side < 2; side++)
+			if(hasReference[side])
+				toGlobal(rigidFrames[frame - gap.first], local[side], global[side]);
+		double weight = hasReference[0] && hasReference[1] ? double(frame - references[0]) / (references[1] - references[0]) : (hasReference[1] ? 1 : 0);
+		float value[3];
+		for(uint axis = 0; axis < 3; axis++)
+			value[axis] = float((hasReference[0] ? (1 - weight) * global[0][axis] : 0) + (hasReference[1] ? weight * global[1][axis] : 0));
+		Marker::Position position = {value[0], value[1], value[2]};
+		trajectory.setPosition(frame, marker, position, true);
+	}
+	return true;
+}
\ No newline at end of file
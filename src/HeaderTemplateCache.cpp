@@ -0,0 +1,59 @@
+///
+/// \file HeaderTemplateCache.cpp
+/// \brief Process-wide cache of c3d header templates
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "HeaderTemplateCache.h"
+#include <fstream>
+#include <iostream>
+
+using namespace C3D;
+
+std::mutex HeaderTemplateCache::_lock;
+std::map<HeaderTemplateCache::TemplateKey, std::shared_ptr<const UuIcsC3d::C3dFileInfo> > HeaderTemplateCache::_templates;
+
+// --------------------------------------------------------- Public Functions
+std::shared_ptr<const UuIcsC3d::C3dFileInfo> HeaderTemplateCache::get(std::string fileName, uint numMarkers)
+{
+	TemplateKey key(fileName, numMarkers);
+	std::lock_guard<std::mutex> lock(_lock);
+	std::map<TemplateKey, std::shared_ptr<const UuIcsC3d::C3dFileInfo> >::iterator found = _templates.find(key);
+	if(found != _templates.end())
+		return found->second;
+
+	std::shared_ptr<const UuIcsC3d::C3dFileInfo> fileInfo = build(fileName, numMarkers);
+	_templates[key] = fileInfo;
+	return fileInfo;
+}
+
+// --------------------------------------------------------- Private Functions
+std::shared_ptr<const UuIcsC3d::C3dFileInfo> HeaderTemplateCache::build(std::string fileName, uint numMarkers)
+{
+	std::ifstream templateFileIn(fileName.c_str());
+	if(!templateFileIn)
+	{
+		std::cerr << "C3D::HeaderTemplateCache::build(): Cannot find " << fileName << std::endl;
+		return std::shared_ptr<const UuIcsC3d::C3dFileInfo>();
+	}
+	templateFileIn.close();
+
+	try
+	{
+		std::shared_ptr<UuIcsC3d::C3dFileInfo> fileInfo = std::make_shared<UuIcsC3d::C3dFileInfo>(fileName);
+		if(numMarkers > 0 && fileInfo->points_per_frame() != int(numMarkers))
+			fileInfo->set_points_per_frame(numMarkers);
+		fileInfo->set_frame_count(0);
+		return fileInfo;
+	}
+	catch(UuIcsC3d::OpenError & e)
+	{
+		std::cerr << "C3D::HeaderTemplateCache::build(): Cannot open the file: " << e.filename() << std::endl;
+	}
+	catch(UuIcsC3d::ContentError & e)
+	{
+		std::cerr << "C3D::HeaderTemplateCache::build(): " << e.msg() << ": " << fileName << std::endl;
+	}
+	return std::shared_ptr<const UuIcsC3d::C3dFileInfo>();
+}
\ No newline at end of file
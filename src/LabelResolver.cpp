@@ -0,0 +1,110 @@
+///
+/// \file LabelResolver.cpp
+/// \brief Resolution of point labels to the markers of the body parts
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "LabelResolver.h"
+#include "subjects.hpp"
+#include <iostream>
+
+using namespace C3D;
+
+std::mutex LabelResolver::_lock;
+std::map<std::string, std::shared_ptr<const MarkerIndex> > LabelResolver::_indices;
+
+// --------------------------------------------------------- Constructors
+MarkerIndex::MarkerIndex(const MarkerLayout & layout) :
+	_points(layout.getNumMarkers(), Marker::NO_MARKER)
+{
+	_groupStart[LEFT_FOOT] = layout.getIndex(LEFT_FOOT, 0);
+	_groupStart[RIGHT_FOOT] = layout.getIndex(RIGHT_FOOT, 0);
+	_groupStart[PELVIS] = layout.getIndex(PELVIS, 0);
+	_groupStart[NUM_BODY_PARTS] = layout.getNumMarkers();
+}
+
+// --------------------------------------------------------- Public Functions
+std::vector<uint> MarkerIndex::getPoints(BodyParts part) const
+{
+	return std::vector<uint>(_points.begin() + _groupStart[part], _points.begin() + _groupStart[part + 1]);
+}
+
+const std::vector<uint> & MarkerIndex::getAllPoints() const
+{
+	return _points;
+}
+
+bool MarkerIndex::isComplete() const
+{
+	for(uint i = 0; i < _points.size(); i++)
+		if(_points[i] == Marker::NO_MARKER)
+			return false;
+	return true;
+}
+
+std::string MarkerIndex::getSubjectName() const
+{
+	return _subjectName;
+}
+
+void MarkerIndex::setPoint(uint marker, uint point)
+{
+	_points[marker] = point;
+}
+
+void MarkerIndex::setSubjectName(std::string subjectName)
+{
+	_subjectName = subjectName;
+}
+
+std::shared_ptr<const MarkerIndex> LabelResolver::resolve(const std::vector<std::string> & pointLabels, const MarkerLayout & layout)
+{
+	std::string signature = layout.getSignature() + "\n";
+	for(uint i = 0; i < pointLabels.size(); i++)
+		signature += pointLabels[i] + "\n";
+
+	std::lock_guard<std::mutex> lock(_lock);
+	std::map<std::string, std::shared_ptr<const MarkerIndex> >::iterator found = _indices.find(signature);
+	if(found != _indices.end())
+		return found->second;
+
+	std::shared_ptr<const MarkerIndex> index = build(pointLabels, layout);
+	_indices[signature] = index;
+	return index;
+}
+
+// --------------------------------------------------------- Private Functions
+std::shared_ptr<const MarkerIndex> LabelResolver::build(const std::vector<std::string> & pointLabels, const MarkerLayout & layout)
+{
+	std::shared_ptr<MarkerIndex> index = std::make_shared<MarkerIndex>(layout);
+	std::vector<UuIcsC3d::SpacePaddedString> labels;
+	for(uint i = 0; i < pointLabels.size(); i++)
+		labels.push_back(UuIcsC3d::SpacePaddedString(pointLabels[i]));
+
+	// fill_skeletons gives one skeleton per label prefix, keep the subject with the most markers
+	std::vector<UuIcsC3d::LabeledSkeleton> skeletons;
+	UuIcsC3d::fill_skeletons(skeletons, labels, layout);
+	uint bestFound = 0;
+	for(uint s = 0; s < skeletons.size(); s++)
+	{
+		const std::vector<std::vector<int> > & groups = skeletons[s].point_index();
+		uint numFound = 0;
+		for(uint g = 0; g < groups.size(); g++)
+			for(uint e = 0; e < groups[g].size(); e++)
+				if(groups[g][e] >= 0)
+					numFound++;
+		if(numFound <= bestFound)
+			continue;
+
+		bestFound = numFound;
+		index->setSubjectName(skeletons[s].name());
+		for(uint g = 0; g < groups.size(); g++)
+			for(uint e = 0; e < groups[g].size(); e++)
+				index->setPoint(layout.getIndex(BodyParts(g), e), groups[g][e] >= 0 ? uint(groups[g][e]) : Marker::NO_MARKER);
+	}
+
+	if(!index->isComplete())
+		std::cerr << "C3D::LabelResolver::build(): " << bestFound << " of " << layout.getNumMarkers() << " markers found in the point labels" << std::endl;
+	return index;
+}
\ No newline at end of file
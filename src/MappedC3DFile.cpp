@@ -0,0 +1,265 @@
+///
+/// \file MappedC3DFile.cpp
+/// \brief Memory-mapped access to the frame data of a c3d file
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "MappedC3DFile.h"
+#include "DecodeKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+MappedC3DFile::MappedC3DFile(std::string fileName) :
+	_fileInfo(fileName),
+	_frames(NULL),
+	_encoding(_fileInfo.content().io()->get_encoding()),
+	_frameCount(0),
+	_numPoints(0),
+	_frameSize(0),
+	_pointScale(1.0),
+	_isInteger(false),
+	_analogChannels(0),
+	_analogSamples(0)
+{
+	const UuIcsC3d::FileInfo1 & layout = _fileInfo.fi1();
+	_numPoints = layout.points_per_frame;
+	_frameSize = layout.frame_size;
+	_pointScale = std::fabs(layout.point_scale);
+	_isInteger = layout.is_integer;
+	_analogChannels = getAnalogChannels(_fileInfo);
+	_analogSamples = layout.samples_per_frame;
+
+	// value = (word - OFFSET) * SCALE * GEN_SCALE, missing parameters leave the words unscaled
+	std::vector<float> scales = getParameterValues("ANALOG", "SCALE");
+	std::vector<float> offsets = getParameterValues("ANALOG", "OFFSET");
+	std::vector<float> generalScale = getParameterValues("ANALOG", "GEN_SCALE");
+	_analogScales.assign(_analogChannels, 1.0f);
+	_analogOffsets.assign(_analogChannels, 0.0f);
+	for(uint channel = 0; channel < _analogChannels; channel++)
+	{
+		if(channel < scales.size())
+			_analogScales[channel] = scales[channel];
+		if(channel < offsets.size())
+			_analogOffsets[channel] = offsets[channel];
+		if(!generalScale.empty())
+			_analogScales[channel] *= generalScale[0];
+	}
+
+	try
+	{
+		_mapping = boost::interprocess::file_mapping(fileName.c_str(), boost::interprocess::read_only);
+		_region = boost::interprocess::mapped_region(_mapping, boost::interprocess::read_only);
+	}
+	catch(boost::interprocess::interprocess_exception & e)
+	{
+		std::cerr << "C3D::MappedC3DFile::MappedC3DFile(): Cannot map the file: " << fileName << " (" << e.what() << ")" << std::endl;
+		return;
+	}
+
+	std::size_t dataOffset = std::size_t(layout.data_startblock0) * sizeof(UuIcsC3d::Block);
+	if(_frameSize == 0 || _region.get_size() < dataOffset)
+	{
+		std::cerr << "C3D::MappedC3DFile::MappedC3DFile(): No frame data in the file: " << fileName << std::endl;
+		return;
+	}
+
+	_frames = static_cast<const unsigned char *>(_region.get_address()) + dataOffset;
+	_frameCount = layout.frame_count;
+	std::size_t availableFrames = (_region.get_size() - dataOffset) / _frameSize;
+	if(availableFrames < _frameCount)
+	{
+		std::cerr << "C3D::MappedC3DFile::MappedC3DFile(): File is truncated, reading " << availableFrames << " of " << _frameCount << " frames: " << fileName << std::endl;
+		_frameCount = availableFrames;
+	}
+}
+
+// --------------------------------------------------------- Public Functions
+bool MappedC3DFile::isOpen() const
+{
+	return _frames != NULL;
+}
+
+const UuIcsC3d::C3dFileInfo & MappedC3DFile::getFileInfo() const
+{
+	return _fileInfo;
+}
+
+uint MappedC3DFile::getFrameCount() const
+{
+	return _frameCount;
+}
+
+float MappedC3DFile::getFrameRate() const
+{
+	return isOpen() ? _fileInfo.content().header().frame_rate : 0;
+}
+
+uint MappedC3DFile::getMaxInterpolationGap() const
+{
+	return isOpen() ? std::max(_fileInfo.content().header().max_interpolation_gap, 0) : 0;
+}
+
+uint MappedC3DFile::getNumPoints() const
+{
+	return _numPoints;
+}
+
+std::vector<std::string> MappedC3DFile::getPointLabels() const
+{
+	std::vector<UuIcsC3d::SpacePaddedString> labels = _fileInfo.point_labels();
+	std::vector<std::string> pointLabels(_numPoints);
+	for(uint i = 0; i < labels.size() && i < _numPoints; i++)
+		pointLabels[i] = labels[i].stripped();
+	return pointLabels;
+}
+
+int MappedC3DFile::getPointIndex(std::string label) const
+{
+	std::vector<UuIcsC3d::SpacePaddedString> labels = _fileInfo.point_labels();
+	for(uint i = 0; i < labels.size() && i < _numPoints; i++)
+		if(labels[i].stripped() == label)
+			return i;
+	return -1;
+}
+
+uint MappedC3DFile::readPoints(uint firstFrame, uint numFrames, float * positions, float * residuals) const
+{
+	if(!isOpen() || firstFrame >= _frameCount)
+		return 0;
+	if(numFrames > _frameCount - firstFrame)
+		numFrames = _frameCount - firstFrame;
+
+	for(uint frame = 0; frame < numFrames; frame++)
+	{
+		const unsigned char * in = _frames + std::size_t(firstFrame + frame) * _frameSize;
+		decodePoints(in, _numPoints, _isInteger, _encoding, _pointScale, positions, residuals);
+		positions += 3 * _numPoints;
+		if(residuals)
+			residuals += _numPoints;
+	}
+	return numFrames;
+}
+
+uint MappedC3DFile::readPoints(uint firstFrame, uint numFrames, const std::vector<uint> & points, float * positions, float * residuals) const
+{
+	if(!isOpen() || firstFrame >= _frameCount)
+		return 0;
+	if(numFrames > _frameCount - firstFrame)
+		numFrames = _frameCount - firstFrame;
+
+	const uint pointSize = _isInteger ? 8 : 16;
+	for(uint frame = 0; frame < numFrames; frame++)
+	{
+		const unsigned char * in = _frames + std::size_t(firstFrame + frame) * _frameSize;
+		for(uint i = 0; i < points.size();)
+		{
+			if(points[i] >= _numPoints)
+			{
+				positions[0] = positions[1] = positions[2] = std::numeric_limits<float>::quiet_NaN();
+				positions += 3;
+				if(residuals)
+					*residuals++ = -1.0f;
+				i++;
+				continue;
+			}
+
+			// consecutive indices are decoded in one call
+			uint run = 1;
+			while(i + run < points.size() && points[i + run] == points[i] + run && points[i + run] < _numPoints)
+				run++;
+			decodePoints(in + points[i] * pointSize, run, _isInteger, _encoding, _pointScale, positions, residuals);
+			positions += 3 * run;
+			if(residuals)
+				residuals += run;
+			i += run;
+		}
+	}
+	return numFrames;
+}
+
+std::vector<std::string> MappedC3DFile::getAnalogLabels() const
+{
+	std::vector<std::string> analogLabels(_analogChannels);
+	const UuIcsC3d::Group * analogGroup = _fileInfo.content().get_group_checked("ANALOG");
+	const UuIcsC3d::Parameter * labels = analogGroup ? analogGroup->get_parameter_checked("LABELS") : NULL;
+	if(!labels || !labels->contains_string())
+		return analogLabels;
+	std::vector<int> bounds = labels->bounds();
+	uint numLabels = bounds.size() == 2 ? bounds[0] : 1;
+	for(uint channel = 0; channel < numLabels && channel < _analogChannels; channel++)
+		analogLabels[channel] = UuIcsC3d::SpacePaddedString(bounds.size() == 2 ? labels->get_string(channel) : labels->get_the_string()).stripped();
+	return analogLabels;
+}
+
+uint MappedC3DFile::readAnalog(uint firstFrame, uint numFrames, AnalogData & analog) const
+{
+	if(!isOpen() || firstFrame >= _frameCount)
+		numFrames = 0;
+	else if(numFrames > _frameCount - firstFrame)
+		numFrames = _frameCount - firstFrame;
+
+	analog.resize(_analogChannels, numFrames, _analogSamples);
+	analog.setSampleRate(getFrameRate() * _analogSamples);
+	std::vector<std::string> labels = getAnalogLabels();
+	for(uint channel = 0; channel < _analogChannels; channel++)
+		analog.setLabel(channel, labels[channel]);
+	if(numFrames == 0 || _analogChannels == 0 || _analogSamples == 0)
+		return numFrames;
+
+	// the analog block follows the points: [sample][channel] words
+	const uint pointSize = _isInteger ? 8 : 16;
+	const uint wordsPerFrame = _analogChannels * _analogSamples;
+	std::vector<float> words(wordsPerFrame);
+	std::vector<float *> channels(_analogChannels);
+	for(uint channel = 0; channel < _analogChannels; channel++)
+		channels[channel] = analog.getChannel(channel);
+
+	for(uint frame = 0; frame < numFrames; frame++)
+	{
+		const unsigned char * in = _frames + std::size_t(firstFrame + frame) * _frameSize + _numPoints * pointSize;
+		decodeWords(in, wordsPerFrame, _isInteger, _encoding, words.data());
+		const float * word = words.data();
+		for(uint sample = 0; sample < _analogSamples; sample++)
+		{
+			uint index = frame * _analogSamples + sample;
+			for(uint channel = 0; channel < _analogChannels; channel++)
+				channels[channel][index] = (*word++ - _analogOffsets[channel]) * _analogScales[channel];
+		}
+	}
+	return numFrames;
+}
+
+uint MappedC3DFile::getAnalogChannels(const UuIcsC3d::C3dFileInfo & fileInfo)
+{
+	const UuIcsC3d::FileInfo1 & layout = fileInfo.fi1();
+	uint pointBytes = layout.points_per_frame * (layout.is_integer ? 8 : 16);
+	uint wordSize = layout.is_integer ? 2 : 4;
+	if(layout.samples_per_frame <= 0 || layout.frame_size <= int(pointBytes))
+		return 0;
+	return (layout.frame_size - pointBytes) / wordSize / layout.samples_per_frame;
+}
+
+std::vector<float> MappedC3DFile::getParameterValues(std::string groupName, std::string parameterName) const
+{
+	// decoded from the raw bytes, Parameter::get_float throws on valid float parameters
+	std::vector<float> values;
+	const UuIcsC3d::Group * group = _fileInfo.content().get_group_checked(groupName);
+	const UuIcsC3d::Parameter * parameter = group ? group->get_parameter_checked(parameterName) : NULL;
+	if(!parameter)
+		return values;
+	const std::vector<unsigned char> & data = parameter->raw_data();
+	if(parameter->data_type() == UuIcsC3d::Parameter::DtFloat || parameter->data_type() == UuIcsC3d::Parameter::DtShort)
+	{
+		bool isShort = parameter->data_type() == UuIcsC3d::Parameter::DtShort;
+		values.resize(data.size() / (isShort ? 2 : 4));
+		decodeWords(data.data(), values.size(), isShort, _encoding, values.data());
+	}
+	return values;
+}
\ No newline at end of file
@@ -1,68 +1,52 @@
 #include "MarkerData.h"
+#include "StringFunc.h"
+#include <limits>
 #include <string>
 
-Marker::MarkerData::MarkerData()
+Marker::MarkerData::MarkerData() :
+	_valid(false)
 {
+	_position.x = _position.y = _position.z = std::numeric_limits<float>::quiet_NaN();
 }
 
-Marker::MarkerData::MarkerData(const MarkerData & copy) : 
-	_position(copy._position),
-	_timestamp(copy._timestamp)
+Marker::MarkerData::MarkerData(Position position)
 {
+	this->setPosition(position);
 }
 
-Marker::Position Marker::MarkerData::getPosition()
-{
-	this->_mutexLock.lock();
-	Marker::Position position = this->_position;
-	this->_mutexLock.unlock();
-	return position;
-}
 void Marker::MarkerData::setPosition(Position position)
 {
-	this->_mutexLock.lock();
 	this->_position = position;
-	this->_mutexLock.unlock();
+	this->_valid = (position.x == position.x) && (position.y == position.y) && (position.z == position.z);
 }
 void Marker::MarkerData::setPositionX(float x)
 {
-	this->_mutexLock.lock();
-	this->_position.x = x;
-	this->_mutexLock.unlock();
+	Position position = this->_position;
+	position.x = x;
+	this->setPosition(position);
 }
 void Marker::MarkerData::setPositionY(float y)
 {
-	this->_mutexLock.lock();
-	this->_position.y = y;
-	this->_mutexLock.unlock();
+	Position position = this->_position;
+	position.y = y;
+	this->setPosition(position);
 }
 void Marker::MarkerData::setPositionZ(float z)
 {
-	this->_mutexLock.lock();
-	this->_position.z = z;
-	this->_mutexLock.unlock();
-}
-
-void Marker::MarkerData::setTimestamp(std::string timestamp)
-{
-	this->_timestamp = timestamp;
-}
-
-std::string Marker::MarkerData::getTimestamp()
-{
-	return this->_timestamp;
-}
-
-std::string Marker::MarkerData::getString()
-{
-	return std::to_string(this->getPosition().x) + "\t" + std::to_string(this->getPosition().y) + "\t" + std::to_string(this->getPosition().z);
+	Position position = this->_position;
+	position.z = z;
+	this->setPosition(position);
 }
 
-bool Marker::MarkerData::isValid()
+std::string Marker::MarkerData::getString() const
 {
-	if((this->_position.x != this->_position.x) || (this->_position.y != this->_position.y) || (this->_position.z != this->_position.z))
-		return false;
-	else return true;
+	char output[3 * FLOAT_CHARS];
+	char * out = floatToChars(this->_position.x, output);
+	*out++ = '\t';
+	out = floatToChars(this->_position.y, out);
+	*out++ = '\t';
+	out = floatToChars(this->_position.z, out);
+	return std::string(output, out);
 }
 
 
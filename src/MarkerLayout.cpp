@@ -0,0 +1,109 @@
+///
+/// \file MarkerLayout.cpp
+/// \brief Marker names of the body parts
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "MarkerLayout.h"
+#include <iostream>
+
+using namespace C3D;
+
+static const char * DEFAULT_LEFT_FOOT[NUM_FOOT_MARKERS] = {"LFootLeft", "LFootTop", "LFootRight", "LFootBottom"};
+static const char * DEFAULT_RIGHT_FOOT[NUM_FOOT_MARKERS] = {"RFootLeft", "RFootTop", "RFootRight", "RFootBottom"};
+static const char * DEFAULT_PELVIS[NUM_PELVIS_MARKERS] = {"PelvisLeft", "PelvisRight"};
+static const char * GROUP_NAMES[NUM_BODY_PARTS] = {"LeftFoot", "RightFoot", "Pelvis"};
+
+// --------------------------------------------------------- Constructors
+MarkerLayout::MarkerLayout()
+{
+	_names.insert(_names.end(), DEFAULT_LEFT_FOOT, DEFAULT_LEFT_FOOT + NUM_FOOT_MARKERS);
+	_names.insert(_names.end(), DEFAULT_RIGHT_FOOT, DEFAULT_RIGHT_FOOT + NUM_FOOT_MARKERS);
+	_names.insert(_names.end(), DEFAULT_PELVIS, DEFAULT_PELVIS + NUM_PELVIS_MARKERS);
+	_groupStart[LEFT_FOOT] = 0;
+	_groupStart[RIGHT_FOOT] = NUM_FOOT_MARKERS;
+	_groupStart[PELVIS] = 2 * NUM_FOOT_MARKERS;
+	_groupStart[NUM_BODY_PARTS] = _names.size();
+}
+
+MarkerLayout::MarkerLayout(std::vector<std::string> leftFoot, std::vector<std::string> rightFoot, std::vector<std::string> pelvis)
+{
+	if(leftFoot.size() != NUM_FOOT_MARKERS || rightFoot.size() != NUM_FOOT_MARKERS || pelvis.size() != NUM_PELVIS_MARKERS)
+		std::cerr << "C3D::MarkerLayout::MarkerLayout(): Expected " << NUM_FOOT_MARKERS << " names per foot and " << NUM_PELVIS_MARKERS << " for the pelvis" << std::endl;
+	leftFoot.resize(NUM_FOOT_MARKERS);
+	rightFoot.resize(NUM_FOOT_MARKERS);
+	pelvis.resize(NUM_PELVIS_MARKERS);
+
+	_names.insert(_names.end(), leftFoot.begin(), leftFoot.end());
+	_names.insert(_names.end(), rightFoot.begin(), rightFoot.end());
+	_names.insert(_names.end(), pelvis.begin(), pelvis.end());
+	_groupStart[LEFT_FOOT] = 0;
+	_groupStart[RIGHT_FOOT] = NUM_FOOT_MARKERS;
+	_groupStart[PELVIS] = 2 * NUM_FOOT_MARKERS;
+	_groupStart[NUM_BODY_PARTS] = _names.size();
+}
+
+// --------------------------------------------------------- Public Functions
+std::string MarkerLayout::getSignature() const
+{
+	std::string signature;
+	for(uint i = 0; i < _names.size(); i++)
+		signature += _names[i] + "\n";
+	return signature;
+}
+
+std::string const * MarkerLayout::begin() const
+{
+	return _names.data();
+}
+
+std::string const * MarkerLayout::end() const
+{
+	return _names.data() + _names.size();
+}
+
+int MarkerLayout::group_count() const
+{
+	return NUM_BODY_PARTS;
+}
+
+std::string MarkerLayout::group_name(int g) const
+{
+	return GROUP_NAMES[g];
+}
+
+UuIcsC3d::ConstNameRange MarkerLayout::group_members(int g) const
+{
+	std::string * names = const_cast<std::string *>(_names.data());
+	return UuIcsC3d::ConstNameRange(names + _groupStart[g], names + _groupStart[g + 1]);
+}
+
+std::vector<int> MarkerLayout::group_connections(int g) const
+{
+	// both feet are connected to the pelvis
+	std::vector<int> connections;
+	if(g == PELVIS)
+	{
+		connections.push_back(LEFT_FOOT);
+		connections.push_back(RIGHT_FOOT);
+	}
+	else
+		connections.push_back(PELVIS);
+	return connections;
+}
+
+UuIcsC3d::SkeletonInfo::GrEl MarkerLayout::to_grel(int label_no) const
+{
+	GrEl grel;
+	grel.gr = 0;
+	while(grel.gr + 1 < int(NUM_BODY_PARTS) && label_no >= int(_groupStart[grel.gr + 1]))
+		grel.gr++;
+	grel.el = label_no - _groupStart[grel.gr];
+	return grel;
+}
+
+int MarkerLayout::to_label_no(GrEl const & grel) const
+{
+	return _groupStart[grel.gr] + grel.el;
+}
\ No newline at end of file
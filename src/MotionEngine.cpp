@@ -0,0 +1,275 @@
+///
+/// \file MotionEngine.cpp
+/// \brief Speed and rotation speed of the feet and the pelvis
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "MotionEngine.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#define MOTION_ENGINE_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace C3D;
+
+static const float TWO_PI = 6.2831853f;
+static const float INV_TWO_PI = 0.15915494f;
+
+// --------------------------------------------------------- Scalar kernels
+///
+/// \brief wrap an angle difference to [-PI, PI]
+///	\param angle: difference of two orientations
+///	\return shortest equivalent difference
+///
+static inline float wrapAngle(float angle)
+{
+	// rounds to nearest even like the SSE2 kernel, so both give the same values
+	return angle - std::nearbyint(angle * INV_TWO_PI) * TWO_PI;
+}
+
+///
+/// \brief pick the central difference, else the forward one, else the backward one
+///	\param previous: value of the previous frame, NaN if invalid
+///	\param current: value of the frame, NaN if invalid
+///	\param next: value of the next frame, NaN if invalid
+///	\return difference per frame, NaN if the frame or both neighbours are invalid
+///
+static inline float difference(float previous, float current, float next)
+{
+	float central = (next - previous) * 0.5f;
+	float forward = next - current;
+	if(current != current)
+		return current;
+	return central == central ? central : (forward == forward ? forward : current - previous);
+}
+
+///
+/// \brief difference of orientations, each one wrapped before averaging so a turn through PI is not a jump of 2 PI
+///	\param previous: orientation of the previous frame, NaN if invalid
+///	\param current: orientation of the frame, NaN if invalid
+///	\param next: orientation of the next frame, NaN if invalid
+///	\return difference per frame, NaN if the frame or both neighbours are invalid
+///
+static inline float angleDifference(float previous, float current, float next)
+{
+	float central = wrapAngle(next - previous) * 0.5f;
+	float forward = wrapAngle(next - current);
+	if(current != current)
+		return current;
+	return central == central ? central : (forward == forward ? forward : wrapAngle(current - previous));
+}
+
+///
+/// \brief derive consecutive frames, x y z and phi are read one frame before and after
+///	\param x: centroid x
+///	\param y: centroid y
+///	\param z: centroid z
+///	\param phi: orientation
+///	\param count: # of frames
+///	\param speed: count speeds
+///	\param rotSpeed: count rotation speeds
+///
+static void deriveScalar(const float * x, const float * y, const float * z, const float * phi, int count, float * speed, float * rotSpeed)
+{
+	for(int i = 0; i < count; i++)
+	{
+		float dx = difference(x[i - 1], x[i], x[i + 1]);
+		float dy = difference(y[i - 1], y[i], y[i + 1]);
+		float dz = difference(z[i - 1], z[i], z[i + 1]);
+		speed[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+		rotSpeed[i] = std::fabs(angleDifference(phi[i - 1], phi[i], phi[i + 1]));
+	}
+}
+
+#ifdef MOTION_ENGINE_SSE2
+// --------------------------------------------------------- SSE2 kernels
+static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 wrapAngle(__m128 angle)
+{
+	__m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(INV_TWO_PI))));
+	return _mm_sub_ps(angle, _mm_mul_ps(turns, _mm_set1_ps(TWO_PI)));
+}
+
+static inline __m128 pick(__m128 current, __m128 central, __m128 forward, __m128 backward)
+{
+	__m128 result = select(_mm_cmpord_ps(central, central), central, select(_mm_cmpord_ps(forward, forward), forward, backward));
+	return select(_mm_cmpord_ps(current, current), result, current);
+}
+
+static inline __m128 difference(const float * values)
+{
+	__m128 previous = _mm_loadu_ps(values - 1);
+	__m128 current = _mm_loadu_ps(values);
+	__m128 next = _mm_loadu_ps(values + 1);
+	return pick(current, _mm_mul_ps(_mm_sub_ps(next, previous), _mm_set1_ps(0.5f)), _mm_sub_ps(next, current), _mm_sub_ps(current, previous));
+}
+
+static void deriveSSE2(const float * x, const float * y, const float * z, const float * phi, int count, float * speed, float * rotSpeed)
+{
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	int i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 dx = difference(x + i);
+		__m128 dy = difference(y + i);
+		__m128 dz = difference(z + i);
+		_mm_storeu_ps(speed + i, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz))));
+
+		__m128 previous = _mm_loadu_ps(phi + i - 1);
+		__m128 current = _mm_loadu_ps(phi + i);
+		__m128 next = _mm_loadu_ps(phi + i + 1);
+		__m128 dphi = pick(current, _mm_mul_ps(wrapAngle(_mm_sub_ps(next, previous)), _mm_set1_ps(0.5f)), wrapAngle(_mm_sub_ps(next, current)), wrapAngle(_mm_sub_ps(current, previous)));
+		_mm_storeu_ps(rotSpeed + i, _mm_andnot_ps(signMask, dphi));
+	}
+	deriveScalar(x + i, y + i, z + i, phi + i, count - i, speed + i, rotSpeed + i);
+}
+#endif
+
+///
+/// \brief average columns of consecutive frames
+///	\param columns: one column per marker
+///	\param numColumns: # of markers
+///	\param count: # of frames
+///	\param out: count averages, NaN where a marker is NaN
+///
+static void averageColumns(const float * const * columns, uint numColumns, uint count, float * out)
+{
+	const float weight = 1.0f / numColumns;
+	uint i = 0;
+#ifdef MOTION_ENGINE_SSE2
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 sum = _mm_loadu_ps(columns[0] + i);
+		for(uint column = 1; column < numColumns; column++)
+			sum = _mm_add_ps(sum, _mm_loadu_ps(columns[column] + i));
+		_mm_storeu_ps(out + i, _mm_mul_ps(sum, _mm_set1_ps(weight)));
+	}
+#endif
+	for(; i < count; i++)
+	{
+		float sum = columns[0][i];
+		for(uint column = 1; column < numColumns; column++)
+			sum += columns[column][i];
+		out[i] = sum * weight;
+	}
+}
+
+// --------------------------------------------------------- Constructors
+MotionEngine::MotionEngine(const MarkerLayout & layout, OrientationMode mode, uint numThreads) :
+	_layout(layout),
+	_mode(mode),
+	_numThreads(numThreads)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+void MotionEngine::compute(const Marker::Trajectory & trajectory, SequenceMotion & motion) const
+{
+	motion.timeline = trajectory.getTimeline();
+	for(uint part = 0; part < NUM_BODY_PARTS; part++)
+	{
+		BodyParts bodyPart = BodyParts(part);
+		uint numMarkers = bodyPart == PELVIS ? NUM_PELVIS_MARKERS : NUM_FOOT_MARKERS;
+		std::vector<uint> markers(numMarkers);
+		for(uint element = 0; element < numMarkers; element++)
+			markers[element] = _layout.getIndex(bodyPart, element);
+
+		if(bodyPart == PELVIS)
+			computePart(trajectory, markers, markers[PELVIS_LEFT], markers[PELVIS_RIGHT], PI, motion.parts[part]);
+		else
+			computePart(trajectory, markers, markers[FOOT_BOTTOM], markers[FOOT_TOP], 0.0, motion.parts[part]);
+	}
+}
+
+std::map<SequenceKey, SequenceMotion> MotionEngine::computeAll(const std::map<SequenceKey, Marker::Trajectory> & trajectories) const
+{
+	// the map is filled up front, every task owns one value
+	std::map<SequenceKey, SequenceMotion> motions;
+	for(std::map<SequenceKey, Marker::Trajectory>::const_iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		motions[it->first];
+	{
+		ThreadPool pool(_numThreads);
+		for(std::map<SequenceKey, Marker::Trajectory>::const_iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		{
+			const Marker::Trajectory * trajectory = &it->second;
+			SequenceMotion * motion = &motions[it->first];
+			pool.submit([this, trajectory, motion]() { compute(*trajectory, *motion); });
+		}
+		pool.wait();
+	}
+	return motions;
+}
+
+void MotionEngine::derive(const float * x, const float * y, const float * z, const float * orientation, uint count, float * speed, float * rotSpeed)
+{
+#ifdef MOTION_ENGINE_SSE2
+	deriveSSE2(x, y, z, orientation, count, speed, rotSpeed);
+#else
+	deriveScalar(x, y, z, orientation, count, speed, rotSpeed);
+#endif
+}
+
+void MotionEngine::computePart(const Marker::Trajectory & trajectory, const std::vector<uint> & markers, uint fromMarker, uint toMarker, double offset, PartMotion & motion) const
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	uint numFrames = trajectory.getNumFrames();
+	motion.speed.assign(numFrames, nan);
+	motion.orientation.assign(numFrames, nan);
+	motion.rotSpeed.assign(numFrames, nan);
+	if(markers.empty())
+		return;
+	for(uint i = 0; i < markers.size(); i++)
+		if(markers[i] >= trajectory.getNumMarkers())
+			return;
+	if(fromMarker >= trajectory.getNumMarkers() || toMarker >= trajectory.getNumMarkers())
+		return;
+
+	// scratch of one block with one frame of margin on each side, NaN beyond the capture
+	const uint scratchFrames = MOTION_BLOCK_FRAMES + 2;
+	std::vector<float> scratch(4 * scratchFrames);
+	float * centroid[Marker::NUM_AXES] = {&scratch[0], &scratch[scratchFrames], &scratch[2 * scratchFrames]};
+	float * orientation = &scratch[3 * scratchFrames];
+	std::vector<const float *> columns(markers.size());
+
+	for(uint first = 0; first < numFrames; first += MOTION_BLOCK_FRAMES)
+	{
+		uint last = std::min(first + MOTION_BLOCK_FRAMES, numFrames);
+		uint begin = first > 0 ? first - 1 : 0;
+		uint end = std::min(last + 1, numFrames);
+		// scratch index of frame f is f - first + 1
+		uint offsetIn = 1 - (first - begin);
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+		{
+			for(uint marker = 0; marker < markers.size(); marker++)
+				columns[marker] = trajectory.getColumn(markers[marker], Marker::Axis(axis)) + begin;
+			averageColumns(columns.data(), columns.size(), end - begin, centroid[axis] + offsetIn);
+		}
+		computeOrientations(trajectory.getColumn(fromMarker, Marker::AXIS_X) + begin, trajectory.getColumn(fromMarker, Marker::AXIS_Y) + begin,
+			trajectory.getColumn(toMarker, Marker::AXIS_X) + begin, trajectory.getColumn(toMarker, Marker::AXIS_Y) + begin, end - begin, offset, _mode, orientation + offsetIn);
+		if(first == 0)
+		{
+			for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+				centroid[axis][0] = nan;
+			orientation[0] = nan;
+		}
+		if(end == last)
+		{
+			for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+				centroid[axis][last - first + 1] = nan;
+			orientation[last - first + 1] = nan;
+		}
+
+		std::copy(orientation + 1, orientation + 1 + (last - first), &motion.orientation[first]);
+		derive(centroid[Marker::AXIS_X] + 1, centroid[Marker::AXIS_Y] + 1, centroid[Marker::AXIS_Z] + 1, orientation + 1, last - first, &motion.speed[first], &motion.rotSpeed[first]);
+	}
+}
\ No newline at end of file
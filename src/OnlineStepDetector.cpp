@@ -0,0 +1,142 @@
+///
+/// \file OnlineStepDetector.cpp
+/// \brief Step detection on a live stream of frames
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "OnlineStepDetector.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+OnlineStepDetector::OnlineStepDetector(std::function<void(StepEvent, const Step &)> listener, const Subject::Thresholds & thresholds, const MarkerLayout & layout) :
+	_thresholds(thresholds),
+	_layout(layout),
+	_listener(listener),
+	_numFrames(0)
+{
+	reset();
+}
+
+// --------------------------------------------------------- Public Functions
+void OnlineStepDetector::update(const Marker::Position * positions)
+{
+	const float weight = 1.0f / NUM_FOOT_MARKERS;
+	for(uint foot = LEFT_FOOT; foot <= RIGHT_FOOT; foot++)
+	{
+		FootState & state = _feet[foot];
+		state.frames[0] = state.frames[1];
+		state.frames[1] = state.frames[2];
+
+		// same operations in the same order as MotionEngine, so the values are identical
+		FootFrame & frame = state.frames[2];
+		for(uint element = 0; element < NUM_FOOT_MARKERS; element++)
+			frame.positions[element] = positions[_layout.getIndex(BodyParts(foot), element)];
+		float sum[Marker::NUM_AXES] = {frame.positions[0].x, frame.positions[0].y, frame.positions[0].z};
+		for(uint element = 1; element < NUM_FOOT_MARKERS; element++)
+		{
+			sum[Marker::AXIS_X] += frame.positions[element].x;
+			sum[Marker::AXIS_Y] += frame.positions[element].y;
+			sum[Marker::AXIS_Z] += frame.positions[element].z;
+		}
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			frame.centroid[axis] = sum[axis] * weight;
+		const Marker::Position & bottom = frame.positions[FOOT_BOTTOM];
+		const Marker::Position & top = frame.positions[FOOT_TOP];
+		computeOrientations(&bottom.x, &bottom.y, &top.x, &top.y, 1, 0.0, ORIENTATION_FAST, &frame.orientation);
+
+		if(_numFrames > 0)
+			step(BodyParts(foot), _numFrames - 1);
+	}
+	_numFrames++;
+}
+
+void OnlineStepDetector::update(const Marker::Trajectory & trajectory)
+{
+	// markers missing from the trajectory stay invalid, as in MotionEngine::computePart()
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	Marker::Position missing = {nan, nan, nan};
+	std::vector<Marker::Position> positions(_layout.getNumMarkers(), missing);
+	uint numMarkers = std::min(trajectory.getNumMarkers(), _layout.getNumMarkers());
+	for(uint frame = 0; frame < trajectory.getNumFrames(); frame++)
+	{
+		for(uint marker = 0; marker < numMarkers; marker++)
+			positions[marker] = trajectory.getPosition(frame, marker);
+		update(positions.data());
+	}
+}
+
+void OnlineStepDetector::flush()
+{
+	if(_numFrames == 0)
+		return;
+	for(uint foot = LEFT_FOOT; foot <= RIGHT_FOOT; foot++)
+	{
+		FootState & state = _feet[foot];
+		state.frames[0] = state.frames[1];
+		state.frames[1] = state.frames[2];
+		clearFrame(state.frames[2]);
+		step(BodyParts(foot), _numFrames - 1);
+	}
+}
+
+void OnlineStepDetector::reset()
+{
+	_numFrames = 0;
+	for(uint foot = LEFT_FOOT; foot <= RIGHT_FOOT; foot++)
+	{
+		FootState & state = _feet[foot];
+		for(uint i = 0; i < 3; i++)
+			clearFrame(state.frames[i]);
+		clearFrame(state.start);
+		state.tracker = StepTracker(_thresholds);
+	}
+}
+
+uint OnlineStepDetector::getNumFrames() const
+{
+	return _numFrames;
+}
+
+// --------------------------------------------------------- Private Functions
+void OnlineStepDetector::clearFrame(FootFrame & frame)
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	for(uint element = 0; element < NUM_FOOT_MARKERS; element++)
+		frame.positions[element].x = frame.positions[element].y = frame.positions[element].z = nan;
+	frame.centroid[Marker::AXIS_X] = frame.centroid[Marker::AXIS_Y] = frame.centroid[Marker::AXIS_Z] = nan;
+	frame.orientation = nan;
+}
+
+void OnlineStepDetector::step(BodyParts foot, uint frame)
+{
+	FootState & state = _feet[foot];
+	const FootFrame * frames = state.frames;
+	float x[3] = {frames[0].centroid[Marker::AXIS_X], frames[1].centroid[Marker::AXIS_X], frames[2].centroid[Marker::AXIS_X]};
+	float y[3] = {frames[0].centroid[Marker::AXIS_Y], frames[1].centroid[Marker::AXIS_Y], frames[2].centroid[Marker::AXIS_Y]};
+	float z[3] = {frames[0].centroid[Marker::AXIS_Z], frames[1].centroid[Marker::AXIS_Z], frames[2].centroid[Marker::AXIS_Z]};
+	float orientation[3] = {frames[0].orientation, frames[1].orientation, frames[2].orientation};
+	float speed, rotSpeed;
+	MotionEngine::derive(x + 1, y + 1, z + 1, orientation + 1, 1, &speed, &rotSpeed);
+
+	StepEvent event = state.tracker.update(speed, rotSpeed);
+	if(event == STEP_NONE)
+		return;
+	if(event == STEP_ENDED)
+	{
+		_listener(event, StepDetector::makeStep(foot, state.tracker.getFirstFrame(), frame, state.start.positions, frames[1].positions, state.start.orientation, frames[1].orientation));
+		return;
+	}
+	if(event == STEP_STARTED)
+		state.start = frames[1];
+	Step step;
+	step.firstFrame = state.tracker.getFirstFrame();
+	step.lastFrame = frame;
+	step.foot = foot;
+	step.displacementX = step.displacementY = step.rotation = 0.0f;
+	_listener(event, step);
+}
\ No newline at end of file
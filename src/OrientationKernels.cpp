@@ -0,0 +1,184 @@
+///
+/// \file OrientationKernels.cpp
+/// \brief Foot and pelvis orientation of every frame of a trajectory
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "OrientationKernels.h"
+#include "DecodeKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ORIENTATION_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace C3D;
+
+// The arctangent is reduced to [0, 1] with the smaller over the larger
+// coordinate, approximated there by an odd polynomial (Abramowitz and Stegun
+// 4.4.49), then unfolded to the octant of the vector. The kernels are
+// branch-free so that every lane follows the same path, and perform the same
+// float operations in the same order (no FMA), so that a frame gets the same
+// angle whether it is computed alone or within a block.
+
+static const float ATAN_C1 = 0.9998660f;
+static const float ATAN_C3 = -0.3302995f;
+static const float ATAN_C5 = 0.1801410f;
+static const float ATAN_C7 = -0.0851330f;
+static const float ATAN_C9 = 0.0208351f;
+static const float HALF_PI = 1.5707963f;
+static const float FULL_PI = 3.1415927f;
+
+// --------------------------------------------------------- Scalar kernels
+static void orientationsExact(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, double offset, float * orientations)
+{
+	// same expression as the scalar Sequence functions, so the results are identical
+	for(uint frame = 0; frame < numFrames; frame++)
+		orientations[frame] = std::atan2(toY[frame] - fromY[frame], toX[frame] - fromX[frame]) + offset;
+}
+
+static void orientationsScalar(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, float offset, float * orientations)
+{
+	for(uint frame = 0; frame < numFrames; frame++)
+		orientations[frame] = fastAtan2(toY[frame] - fromY[frame], toX[frame] - fromX[frame]) + offset;
+}
+
+#ifdef ORIENTATION_KERNELS_X86
+// --------------------------------------------------------- SSE4.1 kernels
+__attribute__((target("sse4.1")))
+static void orientationsSSE41(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, float offset, float * orientations)
+{
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+	uint frame = 0;
+	for(; frame + 4 <= numFrames; frame += 4)
+	{
+		__m128 x = _mm_sub_ps(_mm_loadu_ps(toX + frame), _mm_loadu_ps(fromX + frame));
+		__m128 y = _mm_sub_ps(_mm_loadu_ps(toY + frame), _mm_loadu_ps(fromY + frame));
+		__m128 absX = _mm_andnot_ps(signMask, x);
+		__m128 absY = _mm_andnot_ps(signMask, y);
+		__m128 high = _mm_max_ps(absX, absY);
+		__m128 ratio = _mm_and_ps(_mm_div_ps(_mm_min_ps(absX, absY), high), _mm_cmpgt_ps(high, _mm_setzero_ps()));
+		__m128 square = _mm_mul_ps(ratio, ratio);
+		__m128 angle = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C9), square), _mm_set1_ps(ATAN_C7));
+		angle = _mm_add_ps(_mm_mul_ps(angle, square), _mm_set1_ps(ATAN_C5));
+		angle = _mm_add_ps(_mm_mul_ps(angle, square), _mm_set1_ps(ATAN_C3));
+		angle = _mm_add_ps(_mm_mul_ps(angle, square), _mm_set1_ps(ATAN_C1));
+		angle = _mm_mul_ps(angle, ratio);
+		angle = _mm_blendv_ps(angle, _mm_sub_ps(_mm_set1_ps(HALF_PI), angle), _mm_cmpgt_ps(absY, absX));
+		angle = _mm_blendv_ps(angle, _mm_sub_ps(_mm_set1_ps(FULL_PI), angle), x);
+		angle = _mm_or_ps(angle, _mm_and_ps(signMask, y));
+		angle = _mm_blendv_ps(angle, nan, _mm_cmpunord_ps(x, y));
+		_mm_storeu_ps(orientations + frame, _mm_add_ps(angle, _mm_set1_ps(offset)));
+	}
+	orientationsScalar(fromX + frame, fromY + frame, toX + frame, toY + frame, numFrames - frame, offset, orientations + frame);
+}
+
+// --------------------------------------------------------- AVX2 kernels
+__attribute__((target("avx2")))
+static void orientationsAVX2(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, float offset, float * orientations)
+{
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	const __m256 nan = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+	uint frame = 0;
+	for(; frame + 8 <= numFrames; frame += 8)
+	{
+		__m256 x = _mm256_sub_ps(_mm256_loadu_ps(toX + frame), _mm256_loadu_ps(fromX + frame));
+		__m256 y = _mm256_sub_ps(_mm256_loadu_ps(toY + frame), _mm256_loadu_ps(fromY + frame));
+		__m256 absX = _mm256_andnot_ps(signMask, x);
+		__m256 absY = _mm256_andnot_ps(signMask, y);
+		__m256 high = _mm256_max_ps(absX, absY);
+		__m256 ratio = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(absX, absY), high), _mm256_cmp_ps(high, _mm256_setzero_ps(), _CMP_GT_OQ));
+		__m256 square = _mm256_mul_ps(ratio, ratio);
+		__m256 angle = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(ATAN_C9), square), _mm256_set1_ps(ATAN_C7));
+		angle = _mm256_add_ps(_mm256_mul_ps(angle, square), _mm256_set1_ps(ATAN_C5));
+		angle = _mm256_add_ps(_mm256_mul_ps(angle, square), _mm256_set1_ps(ATAN_C3));
+		angle = _mm256_add_ps(_mm256_mul_ps(angle, square), _mm256_set1_ps(ATAN_C1));
+		angle = _mm256_mul_ps(angle, ratio);
+		angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), angle), _mm256_cmp_ps(absY, absX, _CMP_GT_OQ));
+		angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(FULL_PI), angle), x);
+		angle = _mm256_or_ps(angle, _mm256_and_ps(signMask, y));
+		angle = _mm256_blendv_ps(angle, nan, _mm256_cmp_ps(x, y, _CMP_UNORD_Q));
+		_mm256_storeu_ps(orientations + frame, _mm256_add_ps(angle, _mm256_set1_ps(offset)));
+	}
+	orientationsScalar(fromX + frame, fromY + frame, toX + frame, toY + frame, numFrames - frame, offset, orientations + frame);
+}
+#endif
+
+// --------------------------------------------------------- Public Functions
+float C3D::fastAtan2(float y, float x)
+{
+	if(x != x || y != y)
+		return std::numeric_limits<float>::quiet_NaN();
+	float absX = std::fabs(x);
+	float absY = std::fabs(y);
+	float high = std::max(absX, absY);
+	float ratio = high > 0 ? std::min(absX, absY) / high : 0.0f;
+	float square = ratio * ratio;
+	float angle = ((((ATAN_C9 * square + ATAN_C7) * square + ATAN_C5) * square + ATAN_C3) * square + ATAN_C1) * ratio;
+	if(absY > absX)
+		angle = HALF_PI - angle;
+	if(std::signbit(x))
+		angle = FULL_PI - angle;
+	return std::signbit(y) ? -angle : angle;
+}
+
+void C3D::computeOrientations(const float * fromX, const float * fromY, const float * toX, const float * toY, uint numFrames, double offset, OrientationMode mode, float * orientations)
+{
+	if(mode == ORIENTATION_EXACT)
+	{
+		orientationsExact(fromX, fromY, toX, toY, numFrames, offset, orientations);
+		return;
+	}
+#ifdef ORIENTATION_KERNELS_X86
+	// getInstructionSet() has checked what the CPU supports
+	InstructionSet instructionSet = getInstructionSet();
+	if(instructionSet >= ISA_AVX2)
+	{
+		orientationsAVX2(fromX, fromY, toX, toY, numFrames, offset, orientations);
+		return;
+	}
+	if(instructionSet >= ISA_SSE41)
+	{
+		orientationsSSE41(fromX, fromY, toX, toY, numFrames, offset, orientations);
+		return;
+	}
+#endif
+	orientationsScalar(fromX, fromY, toX, toY, numFrames, offset, orientations);
+}
+
+std::vector<float> C3D::getFootOrientations(const Marker::Trajectory & trajectory, uint topMarker, uint bottomMarker, OrientationMode mode)
+{
+	uint numFrames = trajectory.getNumFrames();
+	std::vector<float> orientations(numFrames, std::numeric_limits<float>::quiet_NaN());
+	if(topMarker >= trajectory.getNumMarkers() || bottomMarker >= trajectory.getNumMarkers())
+		return orientations;
+	computeOrientations(trajectory.getColumn(bottomMarker, Marker::AXIS_X), trajectory.getColumn(bottomMarker, Marker::AXIS_Y),
+		trajectory.getColumn(topMarker, Marker::AXIS_X), trajectory.getColumn(topMarker, Marker::AXIS_Y), numFrames, 0.0f, mode, orientations.data());
+	return orientations;
+}
+
+std::vector<float> C3D::getFootOrientations(const Marker::Trajectory & trajectory, const MarkerIndex & index, BodyParts foot, OrientationMode mode)
+{
+	return getFootOrientations(trajectory, trajectory.findMarker(index.getPoint(foot, FOOT_TOP)), trajectory.findMarker(index.getPoint(foot, FOOT_BOTTOM)), mode);
+}
+
+std::vector<float> C3D::getPelvisOrientations(const Marker::Trajectory & trajectory, uint leftMarker, uint rightMarker, OrientationMode mode)
+{
+	uint numFrames = trajectory.getNumFrames();
+	std::vector<float> orientations(numFrames, std::numeric_limits<float>::quiet_NaN());
+	if(leftMarker >= trajectory.getNumMarkers() || rightMarker >= trajectory.getNumMarkers())
+		return orientations;
+	computeOrientations(trajectory.getColumn(leftMarker, Marker::AXIS_X), trajectory.getColumn(leftMarker, Marker::AXIS_Y),
+		trajectory.getColumn(rightMarker, Marker::AXIS_X), trajectory.getColumn(rightMarker, Marker::AXIS_Y), numFrames, PI, mode, orientations.data());
+	return orientations;
+}
+
+std::vector<float> C3D::getPelvisOrientations(const Marker::Trajectory & trajectory, const MarkerIndex & index, OrientationMode mode)
+{
+	return getPelvisOrientations(trajectory, trajectory.findMarker(index.getPoint(PELVIS, PELVIS_LEFT)), trajectory.findMarker(index.getPoint(PELVIS, PELVIS_RIGHT)), mode);
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+///
+/// \file ReadAheadPipeline.cpp
+/// \brief Background reading of the next c3d files of a batch
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "ReadAheadPipeline.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+ReadAheadPipeline::ReadAheadPipeline(const C3DReader & reader, std::vector<SequenceKey> keys, uint depth, uint numThreads) :
+	_reader(reader),
+	_keys(keys),
+	_nextKey(0),
+	_waitSeconds(0.0),
+	_cancelled(false),
+	_pool(numThreads ? numThreads : std::min(std::max(depth, 1u), ThreadPool::getHardwareThreads()), std::max(depth, 1u))
+{
+	for(uint i = 0; i < std::max(depth, 1u); i++)
+		submitNext();
+}
+
+ReadAheadPipeline::~ReadAheadPipeline()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_cancelled = true;
+	}
+	_pool.wait();
+}
+
+// --------------------------------------------------------- Public Functions
+bool ReadAheadPipeline::next(SequenceKey & key, Marker::Trajectory & trajectory)
+{
+	while(!_slots.empty())
+	{
+		std::shared_ptr<Slot> slot = _slots.front();
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			if(!slot->ready)
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				while(!slot->ready)
+					_slotReady.wait(lock);
+				_waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+		}
+		_slots.pop_front();
+		_timings.push_back(slot->timing);
+
+		// a slot is free again, start reading the next capture while the caller works on this one
+		submitNext();
+		if(slot->timing.loaded)
+		{
+			key = slot->timing.key;
+			trajectory = std::move(slot->trajectory);
+			return true;
+		}
+	}
+	return false;
+}
+
+const std::vector<LoadTiming> & ReadAheadPipeline::getTimings() const
+{
+	return _timings;
+}
+
+double ReadAheadPipeline::getWaitSeconds() const
+{
+	return _waitSeconds;
+}
+
+// --------------------------------------------------------- Private Functions
+void ReadAheadPipeline::submitNext()
+{
+	if(_nextKey == _keys.size())
+		return;
+	std::shared_ptr<Slot> slot(new Slot(_keys[_nextKey++]));
+	_slots.push_back(slot);
+	_pool.submit([this, slot]() { read(slot); });
+}
+
+void ReadAheadPipeline::read(std::shared_ptr<Slot> slot)
+{
+	bool cancelled;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		cancelled = _cancelled;
+	}
+
+	if(!cancelled)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		try
+		{
+			slot->trajectory = _reader.readAllFrames(slot->timing.fileName);
+			slot->timing.loaded = slot->trajectory.getNumFrames() > 0;
+		}
+		catch(UuIcsC3d::OpenError & e)
+		{
+			std::cerr << "C3D::ReadAheadPipeline::read(): Cannot open the file: " << e.filename() << std::endl;
+		}
+		catch(UuIcsC3d::ContentError & e)
+		{
+			std::cerr << "C3D::ReadAheadPipeline::read(): " << e.msg() << ": " << slot->timing.fileName << std::endl;
+		}
+		slot->timing.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		slot->timing.numFrames = slot->trajectory.getNumFrames();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		slot->ready = true;
+	}
+	_slotReady.notify_all();
+}
\ No newline at end of file
@@ -15,14 +15,25 @@ Sequence::Sequence(uint sequenceNumber) :
 {
 }
 
+// --------------------------------------------------------- Public functions
+shared_ptr<const Marker::Trajectory> Sequence::getTrajectory() const
+{
+	return atomic_load(&_trajectory);
+}
+
+void Sequence::setTrajectory(shared_ptr<const Marker::Trajectory> trajectory)
+{
+	atomic_store(&_trajectory, trajectory);
+}
+
 
 // --------------------------------------------------------- Public static functions
-float Sequence::getFootOrientation(vector<Marker::MarkerData> markers)
+float Sequence::getFootOrientation(const vector<Marker::MarkerData> & markers)
 {
 	return atan2(markers[FOOT_TOP].getPosition().y - markers[FOOT_BOTTOM].getPosition().y, markers[FOOT_TOP].getPosition().x - markers[FOOT_BOTTOM].getPosition().x);
 }
 
-float Sequence::getPelvisOrientation(vector<Marker::MarkerData> markers)
+float Sequence::getPelvisOrientation(const vector<Marker::MarkerData> & markers)
 {
 	return atan2(markers[PELVIS_RIGHT].getPosition().y - markers[PELVIS_LEFT].getPosition().y, markers[PELVIS_RIGHT].getPosition().x - markers[PELVIS_LEFT].getPosition().x) + PI;
 }
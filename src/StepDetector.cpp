@@ -0,0 +1,127 @@
+///
+/// \file StepDetector.cpp
+/// \brief Segmentation of the foot motion into steps
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "StepDetector.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace C3D;
+
+// --------------------------------------------------------- Constructors
+StepTracker::StepTracker(const Subject::Thresholds & thresholds) :
+	_thresholds(thresholds),
+	_moving(false),
+	_frame(0),
+	_firstFrame(0),
+	_lastFrame(0)
+{
+}
+
+StepDetector::StepDetector(const Subject::Thresholds & thresholds, const MarkerLayout & layout, uint numThreads) :
+	_thresholds(thresholds),
+	_layout(layout),
+	_engine(layout, ORIENTATION_FAST, 1),
+	_numThreads(numThreads)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+void StepTracker::reset()
+{
+	_moving = false;
+	_frame = 0;
+	_firstFrame = 0;
+	_lastFrame = 0;
+}
+
+std::vector<Step> StepDetector::detect(const Marker::Trajectory & trajectory) const
+{
+	SequenceMotion motion;
+	_engine.compute(trajectory, motion);
+	std::vector<Step> steps;
+	detectFoot(trajectory, motion.parts[LEFT_FOOT], LEFT_FOOT, steps);
+	detectFoot(trajectory, motion.parts[RIGHT_FOOT], RIGHT_FOOT, steps);
+	std::sort(steps.begin(), steps.end(), [](const Step & a, const Step & b) { return a.firstFrame < b.firstFrame || (a.firstFrame == b.firstFrame && a.foot < b.foot); });
+	return steps;
+}
+
+void StepDetector::detectFoot(const Marker::Trajectory & trajectory, const PartMotion & motion, BodyParts foot, std::vector<Step> & steps) const
+{
+	// a foot missing from the trajectory has no steps, whatever the motion says
+	for(uint element = 0; element < NUM_FOOT_MARKERS; element++)
+		if(_layout.getIndex(foot, element) >= trajectory.getNumMarkers())
+			return;
+
+	StepTracker tracker(_thresholds);
+	const float * speed = motion.speed.data();
+	const float * rotSpeed = motion.rotSpeed.data();
+	uint numFrames = motion.speed.size();
+	for(uint frame = 0; frame < numFrames; frame++)
+	{
+		if(tracker.update(speed[frame], rotSpeed[frame]) != STEP_ENDED)
+			continue;
+		uint firstFrame = tracker.getFirstFrame();
+		uint lastFrame = tracker.getLastFrame();
+		Marker::Position firstPositions[NUM_FOOT_MARKERS];
+		Marker::Position lastPositions[NUM_FOOT_MARKERS];
+		for(uint element = 0; element < NUM_FOOT_MARKERS; element++)
+		{
+			firstPositions[element] = trajectory.getPosition(firstFrame, _layout.getIndex(foot, element));
+			lastPositions[element] = trajectory.getPosition(lastFrame, _layout.getIndex(foot, element));
+		}
+		steps.push_back(makeStep(foot, firstFrame, lastFrame, firstPositions, lastPositions, motion.orientation[firstFrame], motion.orientation[lastFrame]));
+	}
+}
+
+std::map<SequenceKey, std::vector<Step> > StepDetector::detectAll(const std::map<SequenceKey, Marker::Trajectory> & trajectories) const
+{
+	// the map is filled up front, every task owns one value
+	std::map<SequenceKey, std::vector<Step> > steps;
+	for(std::map<SequenceKey, Marker::Trajectory>::const_iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		steps[it->first];
+	{
+		ThreadPool pool(_numThreads);
+		for(std::map<SequenceKey, Marker::Trajectory>::const_iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		{
+			const Marker::Trajectory * trajectory = &it->second;
+			std::vector<Step> * sequenceSteps = &steps[it->first];
+			pool.submit([this, trajectory, sequenceSteps]() { *sequenceSteps = detect(*trajectory); });
+		}
+		pool.wait();
+	}
+	return steps;
+}
+
+std::map<SequenceKey, std::vector<Step> > StepDetector::detectSubject(DatasetLoader & loader, uint subjectNumber) const
+{
+	loader.getReader().setMarkerSubset(_layout);
+	return detectAll(loader.loadSubject(subjectNumber));
+}
+
+Step StepDetector::makeStep(BodyParts foot, uint firstFrame, uint lastFrame, const Marker::Position * firstPositions, const Marker::Position * lastPositions, float firstOrientation, float lastOrientation)
+{
+	Step step;
+	step.firstFrame = firstFrame;
+	step.lastFrame = lastFrame;
+	step.foot = foot;
+
+	// both ends are frames with a valid speed, so every foot marker is valid there
+	float displacementX = 0.0f;
+	float displacementY = 0.0f;
+	for(uint element = 0; element < NUM_FOOT_MARKERS; element++)
+	{
+		displacementX += lastPositions[element].x - firstPositions[element].x;
+		displacementY += lastPositions[element].y - firstPositions[element].y;
+	}
+	step.displacementX = displacementX / NUM_FOOT_MARKERS;
+	step.displacementY = displacementY / NUM_FOOT_MARKERS;
+
+	float rotation = lastOrientation - firstOrientation;
+	step.rotation = rotation - 2 * PI * std::floor(rotation / (2 * PI) + 0.5);
+	return step;
+}
\ No newline at end of file
@@ -6,11 +6,21 @@
 ///
 
 #include "StringFunc.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12};
+static const unsigned int MAX_FIXED_DECIMALS = 12;		///< 5^12 < 2^28, so that the products below stay exact
+static const double MAX_EXACT_INTEGER = 9007199254740992.0;	///< 2^53
+static const double MIN_FIXED_VALUE = 1e-6;				///< smaller values are printed by printf
+static const double MAX_FIXED_VALUE = 1e15;				///< larger values are printed by printf
 
 int stringToInt(string input)
 {
 	int output;
-	istringstream ss;
+	istringstream ss(input);
 	ss >> output;
 	return output;
 }
@@ -18,15 +28,77 @@ int stringToInt(string input)
 unsigned int stringToUInt(string input)
 {
 	unsigned int output;
-	istringstream ss;
+	istringstream ss(input);
 	ss >> output;
 	return output;
 }
 
 string intToString(int input)
 {
-	string output;
 	ostringstream ss;
-	ss << output;
-	return output;
+	ss << input;
+	return ss.str();
+}
+
+char * floatToChars(float input, char * output)
+{
+	if(input != input)
+	{
+		std::memcpy(output, "NaN", 3);
+		return output + 3;
+	}
+	char * out = output;
+	if(std::signbit(input))
+		*out++ = '-';
+	double value = std::fabs(double(input));
+	if(value == 0)
+	{
+		*out++ = '0';
+		return out;
+	}
+	if(value < MIN_FIXED_VALUE || value >= MAX_FIXED_VALUE || std::isinf(value))
+		return out + std::sprintf(out, "%.9g", value);
+
+	// interval of the reals that round to the float, its bounds are exact in double
+	uint32_t bits;
+	std::memcpy(&bits, &input, sizeof(bits));
+	uint32_t mantissaBits = bits & 0x7FFFFF;
+	uint64_t halfUlpBits = uint64_t(((bits >> 23) & 0xFF) - 127 - 24 + 1023) << 52;
+	double halfUlp;
+	std::memcpy(&halfUlp, &halfUlpBits, sizeof(halfUlp));
+	double low = value - (mantissaBits == 0 ? halfUlp / 2 : halfUlp);
+	double high = value + halfUlp;
+	bool evenMantissa = (mantissaBits & 1) == 0;
+
+	// the first number of decimals whose rounded value stays in the interval gives the shortest decimal;
+	// the products are exact, at most 25 bits of the float times 21 bits of the power of ten
+	for(unsigned int decimals = 0; decimals <= MAX_FIXED_DECIMALS; decimals++)
+	{
+		double scale = POWERS_OF_TEN[decimals];
+		if(value * scale >= MAX_EXACT_INTEGER)
+			break;
+		double scaled = double(int64_t(value * scale + 0.5));
+		if(scaled < low * scale || scaled > high * scale || ((scaled == low * scale || scaled == high * scale) && !evenMantissa))
+			continue;
+
+		// digits of the scaled value, least significant first
+		char digits[24];
+		int numDigits = 0;
+		for(uint64_t integer = uint64_t(scaled); integer > 0 || numDigits <= int(decimals); integer /= 10)
+			digits[numDigits++] = '0' + integer % 10;
+		for(int i = numDigits - 1; i >= 0; i--)
+		{
+			*out++ = digits[i];
+			if(i == int(decimals) && decimals > 0)
+				*out++ = '.';
+		}
+		return out;
+	}
+	return out + std::sprintf(out, "%.9g", value);
+}
+
+string floatToString(float input)
+{
+	char output[FLOAT_CHARS];
+	return string(output, floatToChars(input, output));
 }
\ No newline at end of file
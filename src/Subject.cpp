@@ -21,6 +21,11 @@ void Subject::setThresholds(Subject::Thresholds thresholds)
 	_thresholds = thresholds;
 }
 
+Subject::Thresholds Subject::getThresholds() const
+{
+	return _thresholds;
+}
+
 void Subject::calibrate()
 {
 	string pCalibFileName = _c3dDirectory + "//Body.c3d";
@@ -28,9 +33,9 @@ void Subject::calibrate()
 	string rCalibFileName = _c3dDirectory + "//Right.c3d";
 	
 	C3D::C3DReader reader(NUM_MARKERS, FRAME_RATE);
-	/*std::vector<std::map<uint, std::unique_ptr<Marker::MarkerData> > > pelvisCalib = reader.readAllFrames(pCalibFileName);
-	std::vector<std::map<uint, std::unique_ptr<Marker::MarkerData> > > leftFootCalib = reader.readAllFrames(lCalibFileName);
-	std::vector<std::map<uint, std::unique_ptr<Marker::MarkerData> > > rightFootCalib = reader.readAllFrames(rCalibFileName);*/
+	/*Marker::Trajectory pelvisCalib = reader.readAllFrames(pCalibFileName);
+	Marker::Trajectory leftFootCalib = reader.readAllFrames(lCalibFileName);
+	Marker::Trajectory rightFootCalib = reader.readAllFrames(rCalibFileName);*/
 
 	 
 }
\ No newline at end of file
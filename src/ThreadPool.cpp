@@ -0,0 +1,99 @@
+///
+/// \file ThreadPool.cpp
+/// \brief Fixed-size pool of worker threads
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "ThreadPool.h"
+#include <iostream>
+#include <exception>
+
+// --------------------------------------------------------- Constructors
+ThreadPool::ThreadPool(uint numThreads, uint maxInFlight) :
+	_maxInFlight(maxInFlight),
+	_inFlight(0),
+	_stopping(false)
+{
+	if(numThreads == 0)
+		numThreads = getHardwareThreads();
+	if(_maxInFlight == 0)
+		_maxInFlight = 2 * numThreads;
+	for(uint i = 0; i < numThreads; i++)
+		_workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_taskAvailable.notify_all();
+	for(uint i = 0; i < _workers.size(); i++)
+		_workers[i].join();
+}
+
+// --------------------------------------------------------- Public Functions
+void ThreadPool::submit(std::function<void()> task)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(_inFlight >= _maxInFlight)
+		_slotAvailable.wait(lock);
+	_inFlight++;
+	_tasks.push_back(task);
+	lock.unlock();
+	_taskAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(_inFlight > 0)
+		_slotAvailable.wait(lock);
+}
+
+uint ThreadPool::getNumThreads() const
+{
+	return _workers.size();
+}
+
+uint ThreadPool::getHardwareThreads()
+{
+	uint numThreads = std::thread::hardware_concurrency();
+	return numThreads > 0 ? numThreads : 1;
+}
+
+// --------------------------------------------------------- Private Functions
+void ThreadPool::work()
+{
+	while(true)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while(_tasks.empty() && !_stopping)
+			_taskAvailable.wait(lock);
+		if(_tasks.empty())
+			return;
+		std::function<void()> task = _tasks.front();
+		_tasks.pop_front();
+		lock.unlock();
+
+		try
+		{
+			task();
+		}
+		catch(std::exception & e)
+		{
+			std::cerr << "ThreadPool::work(): Task failed: " << e.what() << std::endl;
+		}
+		catch(...)
+		{
+			std::cerr << "ThreadPool::work(): Task failed" << std::endl;
+		}
+
+		lock.lock();
+		_inFlight--;
+		lock.unlock();
+		_slotAvailable.notify_all();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+///
+/// \file Timeline.cpp
+/// \brief Mapping between frame indices and time
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "Timeline.h"
+#include <cmath>
+
+using namespace Marker;
+
+// --------------------------------------------------------- Constructors
+Timeline::Timeline(float frameRate, uint firstFrame) :
+	_frameRate(FRAME_RATE),
+	_firstFrame(firstFrame)
+{
+	setFrameRate(frameRate);
+}
+
+// --------------------------------------------------------- Public Functions
+void Timeline::setFrameRate(float frameRate)
+{
+	// a header without a frame rate falls back to the rate of the dataset
+	_frameRate = frameRate > 0 ? frameRate : FRAME_RATE;
+}
+
+uint Timeline::getFrame(double time, uint numFrames) const
+{
+	double frame = std::floor(time * _frameRate + 0.5) - _firstFrame;
+	if(numFrames == 0 || !(frame > 0))
+		return 0;
+	if(frame >= numFrames)
+		return numFrames - 1;
+	return uint(frame);
+}
+
+uint Timeline::getNumFrames(double seconds) const
+{
+	return seconds > 0 ? uint(std::floor(seconds * _frameRate + 0.5)) : 0;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+///
+/// \file Trajectory.cpp
+/// \brief Columnar storage of marker trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "Trajectory.h"
+#include <limits>
+
+using namespace Marker;
+
+// --------------------------------------------------------- Constructors
+Trajectory::Trajectory() :
+	_numFrames(0),
+	_numMarkers(0),
+	_maskWords(0)
+{
+}
+
+Trajectory::Trajectory(uint numFrames, uint numMarkers) :
+	_numFrames(0),
+	_numMarkers(0),
+	_maskWords(0)
+{
+	resize(numFrames, numMarkers);
+}
+
+// --------------------------------------------------------- Public Functions
+void Trajectory::resize(uint numFrames, uint numMarkers)
+{
+	_numFrames = numFrames;
+	_timeline.setFirstFrame(0);
+	_numMarkers = numMarkers;
+	_maskWords = (numFrames + MASK_BITS - 1) / MASK_BITS;
+	_positions.assign(std::size_t(numMarkers) * NUM_AXES * numFrames, std::numeric_limits<float>::quiet_NaN());
+	_validity.assign(std::size_t(numMarkers) * _maskWords, 0);
+	_generated.assign(std::size_t(numMarkers) * _maskWords, 0);
+	_markerIDs.resize(numMarkers);
+	for(uint marker = 0; marker < numMarkers; marker++)
+		_markerIDs[marker] = marker;
+}
+
+void Trajectory::setFirstFrame(uint firstFrame)
+{
+	_timeline.setFirstFrame(firstFrame);
+}
+
+void Trajectory::setTimeline(const Timeline & timeline)
+{
+	_timeline = timeline;
+}
+
+void Trajectory::setFrameRate(float frameRate)
+{
+	_timeline.setFrameRate(frameRate);
+}
+
+void Trajectory::setMarkerID(uint marker, uint markerID)
+{
+	_markerIDs[marker] = markerID;
+}
+
+uint Trajectory::findMarker(uint markerID) const
+{
+	for(uint marker = 0; marker < _numMarkers; marker++)
+		if(_markerIDs[marker] == markerID)
+			return marker;
+	return NO_MARKER;
+}
+
+void Trajectory::setPosition(uint frame, uint marker, Position position, bool generated)
+{
+	float * x = getColumn(marker, AXIS_X) + frame;
+	x[0] = position.x;
+	x[_numFrames] = position.y;
+	x[2 * _numFrames] = position.z;
+	std::size_t word = std::size_t(marker) * _maskWords + frame / MASK_BITS;
+	uint64_t bit = uint64_t(1) << (frame % MASK_BITS);
+	_validity[word] |= bit;
+	_generated[word] = generated ? _generated[word] | bit : _generated[word] & ~bit;
+}
+
+void Trajectory::invalidate(uint frame, uint marker)
+{
+	float * x = getColumn(marker, AXIS_X) + frame;
+	x[0] = x[_numFrames] = x[2 * _numFrames] = std::numeric_limits<float>::quiet_NaN();
+	_validity[std::size_t(marker) * _maskWords + frame / MASK_BITS] &= ~(uint64_t(1) << (frame % MASK_BITS));
+	_generated[std::size_t(marker) * _maskWords + frame / MASK_BITS] &= ~(uint64_t(1) << (frame % MASK_BITS));
+}
+
+MarkerData Trajectory::getMarkerData(uint frame, uint marker) const
+{
+	return isValid(frame, marker) ? MarkerData(getPosition(frame, marker)) : MarkerData();
+}
\ No newline at end of file
@@ -0,0 +1,441 @@
+///
+/// \file TrajectoryArchive.cpp
+/// \brief Compressed archive of trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "TrajectoryArchive.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace C3D;
+
+static const char ARCHIVE_MAGIC[8] = {'C', '3', 'D', 'A', 'R', 'C', 'H', '2'};
+static const uint64_t ARCHIVE_ALIGNMENT = 8;
+static const uint RICE_PARAMETER_BITS = 5;			///< Rice parameters are 0 to 31
+static const uint RICE_ESCAPE = 24;					///< unary length that announces a raw value
+static const uint RAW_LENGTH_BITS = 6;				///< bit length - 1 of a raw value
+
+///
+/// \brief round an offset up to the archive alignment
+///
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+///
+/// \brief low bits of a word
+///
+static inline uint64_t lowBits(uint64_t value, uint bits)
+{
+	return bits >= 64 ? value : value & ((uint64_t(1) << bits) - 1);
+}
+
+///
+/// \class BitWriter
+/// \brief appends bits to a byte vector, least significant bit first
+///
+class BitWriter
+{
+	std::vector<unsigned char> &	_out;
+	uint64_t						_buffer;
+	uint							_count;
+
+public:
+	BitWriter(std::vector<unsigned char> & out) :
+		_out(out),
+		_buffer(0),
+		_count(0)
+	{
+	}
+
+	void put(uint64_t value, uint bits)
+	{
+		if(bits > 32)
+		{
+			put(lowBits(value, 32), 32);
+			put(value >> 32, bits - 32);
+			return;
+		}
+		_buffer |= value << _count;
+		_count += bits;
+		while(_count >= 8)
+		{
+			_out.push_back(_buffer & 0xFF);
+			_buffer >>= 8;
+			_count -= 8;
+		}
+	}
+
+	/// flush the last bits and pad with at least 8 zero bytes, so that the reader can always load a whole word
+	void finish()
+	{
+		if(_count)
+			_out.push_back(_buffer & 0xFF);
+		_buffer = 0;
+		_count = 0;
+		_out.resize(alignOffset(_out.size()) + ARCHIVE_ALIGNMENT, 0);
+	}
+};
+
+///
+/// \brief at least 57 bits starting at a bit position
+///
+static inline uint64_t peekBits(const unsigned char * in, uint64_t position)
+{
+	uint64_t word;
+	std::memcpy(&word, in + (position >> 3), sizeof(word));
+	return word >> (position & 7);
+}
+
+///
+/// \brief up to 64 bits starting at a bit position
+///
+static inline uint64_t readBits(const unsigned char * in, uint64_t position, uint bits)
+{
+	if(bits <= 32)
+		return lowBits(peekBits(in, position), bits);
+	return lowBits(peekBits(in, position), 32) | (lowBits(peekBits(in, position + 32), bits - 32) << 32);
+}
+
+// --------------------------------------------------------- Constructors
+TrajectoryArchive::TrajectoryArchive(std::string fileName) :
+	_header(NULL),
+	_index(NULL)
+{
+	std::ifstream archiveFileIn(fileName.c_str());
+	if(!archiveFileIn)
+	{
+		std::cerr << "C3D::TrajectoryArchive::TrajectoryArchive(): Cannot find " << fileName << std::endl;
+		return;
+	}
+	archiveFileIn.close();
+
+	try
+	{
+		_mapping = boost::interprocess::file_mapping(fileName.c_str(), boost::interprocess::read_only);
+		_region = boost::interprocess::mapped_region(_mapping, boost::interprocess::read_only);
+	}
+	catch(boost::interprocess::interprocess_exception & e)
+	{
+		std::cerr << "C3D::TrajectoryArchive::TrajectoryArchive(): Cannot map the archive: " << fileName << " (" << e.what() << ")" << std::endl;
+		return;
+	}
+
+	uint64_t fileSize = _region.get_size();
+	const ArchiveHeader * header = static_cast<const ArchiveHeader *>(_region.get_address());
+	if(fileSize < sizeof(ArchiveHeader) || std::memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0
+		|| header->labelOffset + uint64_t(header->numMarkers) * ARCHIVE_LABEL_SIZE > header->indexOffset
+		|| header->indexOffset + uint64_t(header->numMarkers) * sizeof(ColumnIndex) > fileSize)
+	{
+		std::cerr << "C3D::TrajectoryArchive::TrajectoryArchive(): Not an archive: " << fileName << std::endl;
+		return;
+	}
+
+	const ColumnIndex * index = reinterpret_cast<const ColumnIndex *>(static_cast<const unsigned char *>(_region.get_address()) + header->indexOffset);
+	uint64_t maskSize = (uint64_t(header->numFrames) + Marker::MASK_BITS - 1) / Marker::MASK_BITS * sizeof(uint64_t);
+	uint64_t minimumSize = maskSize + Marker::NUM_AXES * sizeof(uint64_t);
+	for(uint column = 0; column < header->numMarkers; column++)
+		if(index[column].offset % ARCHIVE_ALIGNMENT || index[column].offset + index[column].size > fileSize
+			|| index[column].size < minimumSize + (index[column].flags & ARCHIVE_HAS_GENERATED ? maskSize : 0))
+		{
+			std::cerr << "C3D::TrajectoryArchive::TrajectoryArchive(): Corrupt column index: " << fileName << std::endl;
+			return;
+		}
+
+	_header = header;
+	_index = index;
+}
+
+// --------------------------------------------------------- Public Functions
+bool TrajectoryArchive::isValid() const
+{
+	return _header != NULL;
+}
+
+uint TrajectoryArchive::getNumFrames() const
+{
+	return _header ? _header->numFrames : 0;
+}
+
+uint TrajectoryArchive::getNumMarkers() const
+{
+	return _header ? _header->numMarkers : 0;
+}
+
+double TrajectoryArchive::getPrecision() const
+{
+	return _header ? _header->precision : 0.0;
+}
+
+std::vector<std::string> TrajectoryArchive::getLabels() const
+{
+	std::vector<std::string> labels;
+	if(!_header)
+		return labels;
+	const char * label = static_cast<const char *>(_region.get_address()) + _header->labelOffset;
+	for(uint column = 0; column < _header->numMarkers; column++, label += ARCHIVE_LABEL_SIZE)
+		labels.push_back(std::string(label, strnlen(label, ARCHIVE_LABEL_SIZE)));
+	return labels;
+}
+
+bool TrajectoryArchive::readMarkers(const std::vector<uint> & columns, Marker::Trajectory & trajectory) const
+{
+	if(!_header)
+		return false;
+	uint numFrames = _header->numFrames;
+	trajectory.resize(numFrames, columns.size());
+	trajectory.setTimeline(Marker::Timeline(_header->frameRate, _header->firstFrame));
+	uint maskWords = trajectory.getMaskWords();
+
+	bool success = true;
+	const unsigned char * base = static_cast<const unsigned char *>(_region.get_address());
+	for(uint marker = 0; marker < columns.size(); marker++)
+	{
+		if(columns[marker] >= _header->numMarkers)
+		{
+			trajectory.setMarkerID(marker, Marker::NO_MARKER);
+			continue;
+		}
+		const ColumnIndex & entry = _index[columns[marker]];
+		const unsigned char * in = base + entry.offset;
+		trajectory.setMarkerID(marker, entry.markerID);
+
+		const uint64_t * validity = reinterpret_cast<const uint64_t *>(in);
+		const uint64_t * generated = entry.flags & ARCHIVE_HAS_GENERATED ? validity + maskWords : NULL;
+		const unsigned char * sizes = in + (generated ? 2 : 1) * maskWords * sizeof(uint64_t);
+		uint64_t streamSizes[Marker::NUM_AXES];
+		std::memcpy(streamSizes, sizes, sizeof(streamSizes));
+		const unsigned char * stream = sizes + sizeof(streamSizes);
+		uint64_t remaining = entry.size - (stream - in);
+
+		bool columnValid = true;
+		for(uint axis = 0; axis < Marker::NUM_AXES && columnValid; axis++)
+		{
+			columnValid = streamSizes[axis] <= remaining && decodeStream(stream, streamSizes[axis], validity, numFrames, trajectory.getColumn(marker, Marker::Axis(axis)));
+			stream += streamSizes[axis];
+			remaining -= std::min(remaining, streamSizes[axis]);
+		}
+		if(columnValid)
+		{
+			std::memcpy(trajectory.getValidityMask(marker), validity, maskWords * sizeof(uint64_t));
+			if(generated)
+				std::memcpy(trajectory.getGeneratedMask(marker), generated, maskWords * sizeof(uint64_t));
+		}
+		else
+		{
+			std::cerr << "C3D::TrajectoryArchive::readMarkers(): Corrupt column " << columns[marker] << std::endl;
+			for(uint frame = 0; frame < numFrames; frame++)
+				trajectory.invalidate(frame, marker);
+			success = false;
+		}
+	}
+	return success;
+}
+
+bool TrajectoryArchive::write(std::string fileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & labels, ArchiveOptions options)
+{
+	if(options.precision <= 0 || (options.predictorOrder != 1 && options.predictorOrder != 2))
+	{
+		std::cerr << "C3D::TrajectoryArchive::write(): Invalid precision or predictor order" << std::endl;
+		return false;
+	}
+
+	uint numFrames = trajectory.getNumFrames();
+	uint numMarkers = trajectory.getNumMarkers();
+	uint maskWords = trajectory.getMaskWords();
+	ArchiveHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+	header.numFrames = numFrames;
+	header.numMarkers = numMarkers;
+	header.firstFrame = trajectory.getFirstFrame();
+	header.frameRate = trajectory.getFrameRate();
+	header.predictorOrder = options.predictorOrder;
+	header.precision = options.precision;
+	header.labelOffset = alignOffset(sizeof(ArchiveHeader));
+	header.indexOffset = alignOffset(header.labelOffset + uint64_t(numMarkers) * ARCHIVE_LABEL_SIZE);
+
+	std::vector<char> labelData(std::size_t(numMarkers) * ARCHIVE_LABEL_SIZE, 0);
+	for(uint marker = 0; marker < numMarkers && marker < labels.size(); marker++)
+		labels[marker].copy(&labelData[marker * ARCHIVE_LABEL_SIZE], ARCHIVE_LABEL_SIZE - 1);
+
+	// encode every column before writing, so that the index can precede them
+	std::vector<ColumnIndex> index(numMarkers);
+	std::vector<std::vector<unsigned char> > columns(numMarkers);
+	uint64_t offset = alignOffset(header.indexOffset + uint64_t(numMarkers) * sizeof(ColumnIndex));
+	for(uint marker = 0; marker < numMarkers; marker++)
+	{
+		std::vector<unsigned char> & column = columns[marker];
+		const uint64_t * validity = trajectory.getValidityMask(marker);
+		column.assign(reinterpret_cast<const unsigned char *>(validity), reinterpret_cast<const unsigned char *>(validity + maskWords));
+
+		// the generated mask is only stored if the marker has generated samples
+		const uint64_t * generated = trajectory.getGeneratedMask(marker);
+		index[marker].flags = 0;
+		for(uint word = 0; word < maskWords && !index[marker].flags; word++)
+			if(generated[word])
+				index[marker].flags = ARCHIVE_HAS_GENERATED;
+		if(index[marker].flags & ARCHIVE_HAS_GENERATED)
+			column.insert(column.end(), reinterpret_cast<const unsigned char *>(generated), reinterpret_cast<const unsigned char *>(generated + maskWords));
+		std::size_t sizesOffset = column.size();
+		column.resize(sizesOffset + Marker::NUM_AXES * sizeof(uint64_t), 0);
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+		{
+			std::size_t streamStart = column.size();
+			encodeStream(trajectory.getColumn(marker, Marker::Axis(axis)), validity, numFrames, options, column);
+			uint64_t streamSize = column.size() - streamStart;
+			std::memcpy(&column[sizesOffset + axis * sizeof(uint64_t)], &streamSize, sizeof(streamSize));
+		}
+
+		index[marker].offset = offset;
+		index[marker].size = column.size();
+		index[marker].markerID = trajectory.getMarkerID(marker);
+		offset += column.size();
+	}
+
+	std::string tempFileName = fileName + ".tmp";
+	std::ofstream archiveFileOut(tempFileName.c_str(), std::ios::binary | std::ios::trunc);
+	if(!archiveFileOut)
+	{
+		if(DEBUG)
+			std::cout << "C3D::TrajectoryArchive::write(): Cannot write to the file: " << tempFileName << std::endl;
+		return false;
+	}
+
+	const char padding[ARCHIVE_ALIGNMENT] = {0};
+	archiveFileOut.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	archiveFileOut.write(padding, header.labelOffset - sizeof(header));
+	archiveFileOut.write(labelData.data(), labelData.size());
+	archiveFileOut.write(padding, header.indexOffset - header.labelOffset - labelData.size());
+	archiveFileOut.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(ColumnIndex));
+	archiveFileOut.write(padding, alignOffset(header.indexOffset + index.size() * sizeof(ColumnIndex)) - header.indexOffset - index.size() * sizeof(ColumnIndex));
+	for(uint marker = 0; marker < numMarkers; marker++)
+		archiveFileOut.write(reinterpret_cast<const char *>(columns[marker].data()), columns[marker].size());
+	archiveFileOut.close();
+
+	if(!archiveFileOut)
+	{
+		std::remove(tempFileName.c_str());
+		return false;
+	}
+	std::remove(fileName.c_str());
+	return std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+}
+
+// --------------------------------------------------------- Private Functions
+void TrajectoryArchive::encodeStream(const float * column, const uint64_t * validity, uint numFrames, const ArchiveOptions & options, std::vector<unsigned char> & out)
+{
+	// zigzagged prediction residuals of the valid frames
+	std::vector<uint64_t> residuals;
+	int64_t previous = 0, beforePrevious = 0;
+	for(uint frame = 0; frame < numFrames; frame++)
+	{
+		if(!((validity[frame / Marker::MASK_BITS] >> (frame % Marker::MASK_BITS)) & 1))
+			continue;
+		double value = column[frame];
+		int64_t quantised = std::isfinite(value) ? std::llround(value / options.precision) : 0;
+		int64_t prediction = residuals.empty() ? 0 : previous;
+		if(options.predictorOrder == 2 && residuals.size() >= 2)
+			prediction = 2 * previous - beforePrevious;
+		int64_t residual = quantised - prediction;
+		residuals.push_back((uint64_t(residual) << 1) ^ uint64_t(residual >> 63));
+		beforePrevious = previous;
+		previous = quantised;
+	}
+
+	BitWriter writer(out);
+	for(std::size_t first = 0; first < residuals.size(); first += ARCHIVE_BLOCK_SIZE)
+	{
+		std::size_t last = std::min(residuals.size(), first + ARCHIVE_BLOCK_SIZE);
+		double sum = 0;
+		for(std::size_t i = first; i < last; i++)
+			sum += double(residuals[i]);
+		double mean = sum / (last - first);
+		uint parameter = mean < 2 ? 0 : std::min(31, int(std::log2(mean)));
+		writer.put(parameter, RICE_PARAMETER_BITS);
+
+		for(std::size_t i = first; i < last; i++)
+		{
+			uint64_t value = residuals[i];
+			uint64_t quotient = value >> parameter;
+			if(quotient < RICE_ESCAPE)
+			{
+				writer.put(uint64_t(1) << quotient, quotient + 1);
+				writer.put(lowBits(value, parameter), parameter);
+			}
+			else
+			{
+				uint length = 64 - __builtin_clzll(value);
+				writer.put(uint64_t(1) << RICE_ESCAPE, RICE_ESCAPE + 1);
+				writer.put(length - 1, RAW_LENGTH_BITS);
+				writer.put(value, length);
+			}
+		}
+	}
+	writer.finish();
+}
+
+bool TrajectoryArchive::decodeStream(const unsigned char * in, uint64_t size, const uint64_t * validity, uint numFrames, float * column) const
+{
+	const double precision = _header->precision;
+	const bool linear = _header->predictorOrder == 2;
+	const uint64_t lastWord = size < sizeof(uint64_t) ? 0 : size - sizeof(uint64_t);
+	uint64_t position = 0;
+	uint parameter = 0;
+	uint64_t decoded = 0;
+	int64_t previous = 0, beforePrevious = 0;
+
+	uint maskWords = (numFrames + Marker::MASK_BITS - 1) / Marker::MASK_BITS;
+	for(uint word = 0; word < maskWords; word++)
+	{
+		// visit the valid frames of the word
+		for(uint64_t bits = validity[word]; bits; bits &= bits - 1)
+		{
+			uint frame = word * Marker::MASK_BITS + __builtin_ctzll(bits);
+			if(frame >= numFrames || (position >> 3) > lastWord)
+				return false;
+			if(decoded % ARCHIVE_BLOCK_SIZE == 0)
+			{
+				parameter = lowBits(peekBits(in, position), RICE_PARAMETER_BITS);
+				position += RICE_PARAMETER_BITS;
+				if((position >> 3) > lastWord)
+					return false;
+			}
+
+			uint64_t bitsAhead = peekBits(in, position);
+			uint quotient = bitsAhead ? __builtin_ctzll(bitsAhead) : 64;
+			uint64_t value;
+			if(quotient < RICE_ESCAPE)
+			{
+				value = (uint64_t(quotient) << parameter) | lowBits(bitsAhead >> (quotient + 1), parameter);
+				position += quotient + 1 + parameter;
+			}
+			else
+			{
+				position += RICE_ESCAPE + 1;
+				if((position >> 3) + 2 * sizeof(uint64_t) > size)
+					return false;
+				uint length = lowBits(peekBits(in, position), RAW_LENGTH_BITS) + 1;
+				position += RAW_LENGTH_BITS;
+				value = readBits(in, position, length);
+				position += length;
+			}
+
+			int64_t residual = int64_t(value >> 1) ^ -int64_t(value & 1);
+			int64_t prediction = decoded == 0 ? 0 : (linear && decoded >= 2 ? 2 * previous - beforePrevious : previous);
+			int64_t quantised = prediction + residual;
+			column[frame] = float(quantised * precision);
+			beforePrevious = previous;
+			previous = quantised;
+			decoded++;
+		}
+	}
+	return (position >> 3) <= size;
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+///
+/// \file TrajectoryCache.cpp
+/// \brief Binary cache of decoded trajectories next to the c3d files
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "TrajectoryCache.h"
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace C3D;
+
+static const char CACHE_MAGIC[8] = {'C', '3', 'D', 'T', 'R', 'A', 'J', '3'};
+static const uint64_t CACHE_ALIGNMENT = 64;
+
+///
+/// \brief round an offset up to the cache alignment
+///
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+}
+
+///
+/// \brief copy the mask of a window of frames, realigned on the first frame of the window
+///
+static void copyWindowMask(const uint64_t * in, const uint64_t * end, uint firstFrame, uint numFrames, uint64_t * out)
+{
+	uint maskWords = (numFrames + Marker::MASK_BITS - 1) / Marker::MASK_BITS;
+	uint shift = firstFrame % Marker::MASK_BITS;
+	in += firstFrame / Marker::MASK_BITS;
+	for(uint word = 0; word < maskWords; word++)
+	{
+		out[word] = in[word] >> shift;
+		if(shift && in + word + 1 < end)
+			out[word] |= in[word + 1] << (Marker::MASK_BITS - shift);
+	}
+	if(numFrames % Marker::MASK_BITS)
+		out[maskWords - 1] &= (uint64_t(1) << (numFrames % Marker::MASK_BITS)) - 1;
+}
+
+///
+/// \brief 64-bit hash of a byte range, four independent lanes so that it runs at memory speed
+///
+static uint64_t hashBytes(const unsigned char * data, std::size_t size)
+{
+	const uint64_t prime = 0x100000001b3ULL;
+	uint64_t lanes[4] = {0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL, 0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL};
+	std::size_t i = 0;
+	for(; i + 32 <= size; i += 32)
+	{
+		uint64_t words[4];
+		std::memcpy(words, data + i, sizeof(words));
+		for(uint lane = 0; lane < 4; lane++)
+		{
+			lanes[lane] = (lanes[lane] ^ words[lane]) * prime;
+			lanes[lane] ^= lanes[lane] >> 29;
+		}
+	}
+	uint64_t hash = size;
+	for(uint lane = 0; lane < 4; lane++)
+		hash = (hash ^ lanes[lane]) * prime;
+	for(; i < size; i++)
+		hash = (hash ^ data[i]) * prime;
+	return hash ^ (hash >> 32);
+}
+
+// --------------------------------------------------------- Constructors
+TrajectoryCache::TrajectoryCache(std::string sourceFileName, bool checkContent) :
+	_header(NULL)
+{
+	std::string cacheFileName = getCacheFileName(sourceFileName);
+	std::ifstream cacheFileIn(cacheFileName.c_str());
+	if(!cacheFileIn)
+		return;
+	cacheFileIn.close();
+
+	try
+	{
+		_mapping = boost::interprocess::file_mapping(cacheFileName.c_str(), boost::interprocess::read_only);
+		_region = boost::interprocess::mapped_region(_mapping, boost::interprocess::read_only);
+	}
+	catch(boost::interprocess::interprocess_exception & e)
+	{
+		std::cerr << "C3D::TrajectoryCache::TrajectoryCache(): Cannot map the cache: " << cacheFileName << " (" << e.what() << ")" << std::endl;
+		return;
+	}
+
+	if(_region.get_size() < sizeof(CacheHeader))
+		return;
+	const CacheHeader * header = static_cast<const CacheHeader *>(_region.get_address());
+	uint64_t maskWords = (uint64_t(header->numFrames) + Marker::MASK_BITS - 1) / Marker::MASK_BITS;
+	if(std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+		|| header->labelOffset + uint64_t(header->numPoints) * CACHE_LABEL_SIZE > header->positionOffset
+		|| header->positionOffset + uint64_t(header->numPoints) * Marker::NUM_AXES * header->numFrames * sizeof(float) > header->validityOffset
+		|| header->validityOffset + uint64_t(header->numPoints) * maskWords * sizeof(uint64_t) > header->generatedOffset
+		|| header->generatedOffset + uint64_t(header->numPoints) * maskWords * sizeof(uint64_t) > _region.get_size())
+		return;
+
+	CacheHeader source;
+	if(!describeSource(sourceFileName, source, checkContent))
+		return;
+	if(source.sourceSize != header->sourceSize || source.sourceTime != header->sourceTime
+		|| source.pathHash != header->pathHash || (checkContent && source.sourceHash != header->sourceHash))
+		return;
+
+	_header = header;
+}
+
+// --------------------------------------------------------- Public Functions
+bool TrajectoryCache::isValid() const
+{
+	return _header != NULL;
+}
+
+uint TrajectoryCache::getNumFrames() const
+{
+	return _header ? _header->numFrames : 0;
+}
+
+std::vector<std::string> TrajectoryCache::getPointLabels() const
+{
+	std::vector<std::string> pointLabels;
+	if(!_header)
+		return pointLabels;
+	const char * labels = static_cast<const char *>(_region.get_address()) + _header->labelOffset;
+	for(uint point = 0; point < _header->numPoints; point++)
+	{
+		const char * label = labels + point * CACHE_LABEL_SIZE;
+		pointLabels.push_back(std::string(label, strnlen(label, CACHE_LABEL_SIZE)));
+	}
+	return pointLabels;
+}
+
+void TrajectoryCache::readMarkers(const std::vector<uint> & markers, Marker::Trajectory & trajectory) const
+{
+	readMarkers(markers, 0, getNumFrames(), trajectory);
+}
+
+void TrajectoryCache::readMarkers(const std::vector<uint> & markers, uint firstFrame, uint numFrames, Marker::Trajectory & trajectory) const
+{
+	if(!_header)
+		return;
+	uint cacheFrames = _header->numFrames;
+	if(firstFrame > cacheFrames)
+		firstFrame = cacheFrames;
+	if(numFrames > cacheFrames - firstFrame)
+		numFrames = cacheFrames - firstFrame;
+
+	const unsigned char * base = static_cast<const unsigned char *>(_region.get_address());
+	const float * positions = reinterpret_cast<const float *>(base + _header->positionOffset);
+	const uint64_t * validity = reinterpret_cast<const uint64_t *>(base + _header->validityOffset);
+	const uint64_t * generated = reinterpret_cast<const uint64_t *>(base + _header->generatedOffset);
+	uint cacheWords = (cacheFrames + Marker::MASK_BITS - 1) / Marker::MASK_BITS;
+
+	trajectory.resize(numFrames, markers.size());
+	trajectory.setTimeline(Marker::Timeline(_header->frameRate, firstFrame));
+	for(uint marker = 0; marker < markers.size(); marker++)
+	{
+		uint point = markers[marker];
+		if(point >= _header->numPoints)
+		{
+			trajectory.setMarkerID(marker, Marker::NO_MARKER);
+			continue;
+		}
+		trajectory.setMarkerID(marker, point);
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			std::memcpy(trajectory.getColumn(marker, Marker::Axis(axis)), positions + (std::size_t(point) * Marker::NUM_AXES + axis) * cacheFrames + firstFrame, numFrames * sizeof(float));
+
+		copyWindowMask(validity + std::size_t(point) * cacheWords, validity + std::size_t(point + 1) * cacheWords, firstFrame, numFrames, trajectory.getValidityMask(marker));
+		copyWindowMask(generated + std::size_t(point) * cacheWords, generated + std::size_t(point + 1) * cacheWords, firstFrame, numFrames, trajectory.getGeneratedMask(marker));
+	}
+}
+
+bool TrajectoryCache::write(std::string sourceFileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & pointLabels)
+{
+	CacheHeader header;
+	std::memset(&header, 0, sizeof(header));
+	if(!describeSource(sourceFileName, header))
+		return false;
+
+	uint numFrames = trajectory.getNumFrames();
+	uint numPoints = trajectory.getNumMarkers();
+	uint maskWords = trajectory.getMaskWords();
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.numFrames = numFrames;
+	header.numPoints = numPoints;
+	header.frameRate = trajectory.getFrameRate();
+	header.labelOffset = alignOffset(sizeof(CacheHeader));
+	header.positionOffset = alignOffset(header.labelOffset + uint64_t(numPoints) * CACHE_LABEL_SIZE);
+	header.validityOffset = alignOffset(header.positionOffset + uint64_t(numPoints) * Marker::NUM_AXES * numFrames * sizeof(float));
+	header.generatedOffset = header.validityOffset + uint64_t(numPoints) * maskWords * sizeof(uint64_t);
+
+	std::vector<char> labels(std::size_t(numPoints) * CACHE_LABEL_SIZE, 0);
+	for(uint point = 0; point < numPoints && point < pointLabels.size(); point++)
+		pointLabels[point].copy(&labels[point * CACHE_LABEL_SIZE], CACHE_LABEL_SIZE - 1);
+
+	// write to a temporary file and rename it, so readers never see a partial cache
+	std::string cacheFileName = getCacheFileName(sourceFileName);
+	std::string tempFileName = cacheFileName + ".tmp";
+	std::ofstream cacheFileOut(tempFileName.c_str(), std::ios::binary | std::ios::trunc);
+	if(!cacheFileOut)
+	{
+		if(DEBUG)
+			std::cout << "C3D::TrajectoryCache::write(): Cannot write to the file: " << tempFileName << std::endl;
+		return false;
+	}
+
+	const char padding[CACHE_ALIGNMENT] = {0};
+	cacheFileOut.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	cacheFileOut.write(padding, header.labelOffset - sizeof(header));
+	cacheFileOut.write(labels.data(), labels.size());
+	cacheFileOut.write(padding, header.positionOffset - header.labelOffset - labels.size());
+	for(uint point = 0; point < numPoints; point++)
+		cacheFileOut.write(reinterpret_cast<const char *>(trajectory.getColumn(point, Marker::AXIS_X)), Marker::NUM_AXES * numFrames * sizeof(float));
+	cacheFileOut.write(padding, header.validityOffset - header.positionOffset - uint64_t(numPoints) * Marker::NUM_AXES * numFrames * sizeof(float));
+	for(uint point = 0; point < numPoints; point++)
+		cacheFileOut.write(reinterpret_cast<const char *>(trajectory.getValidityMask(point)), maskWords * sizeof(uint64_t));
+	for(uint point = 0; point < numPoints; point++)
+		cacheFileOut.write(reinterpret_cast<const char *>(trajectory.getGeneratedMask(point)), maskWords * sizeof(uint64_t));
+	cacheFileOut.close();
+
+	if(!cacheFileOut)
+	{
+		std::remove(tempFileName.c_str());
+		return false;
+	}
+	std::remove(cacheFileName.c_str());
+	return std::rename(tempFileName.c_str(), cacheFileName.c_str()) == 0;
+}
+
+std::string TrajectoryCache::getCacheFileName(std::string sourceFileName)
+{
+	return sourceFileName + ".traj";
+}
+
+// --------------------------------------------------------- Private Functions
+bool TrajectoryCache::describeSource(std::string sourceFileName, CacheHeader & header, bool hashContent)
+{
+	struct stat status;
+	if(stat(sourceFileName.c_str(), &status) != 0 || status.st_size == 0)
+		return false;
+	header.sourceSize = status.st_size;
+	header.sourceTime = status.st_mtime;
+	header.pathHash = hashBytes(reinterpret_cast<const unsigned char *>(sourceFileName.data()), sourceFileName.size());
+	header.sourceHash = 0;
+	if(!hashContent)
+		return true;
+
+	try
+	{
+		boost::interprocess::file_mapping mapping(sourceFileName.c_str(), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+		header.sourceHash = hashBytes(static_cast<const unsigned char *>(region.get_address()), region.get_size());
+	}
+	catch(boost::interprocess::interprocess_exception &)
+	{
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+///
+/// \file TrajectoryExporter.cpp
+/// \brief Text export of trajectories
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "TrajectoryExporter.h"
+#include "ThreadPool.h"
+#include "StringFunc.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+
+using namespace C3D;
+
+static const char * AXIS_NAMES[Marker::NUM_AXES] = {"x", "y", "z"};
+
+// --------------------------------------------------------- Constructors
+TrajectoryExporter::TrajectoryExporter(ExportFormat format, uint numThreads) :
+	_format(format),
+	_numThreads(numThreads)
+{
+}
+
+// --------------------------------------------------------- Public Functions
+bool TrajectoryExporter::write(std::string fileName, const Marker::Trajectory & trajectory, const std::vector<std::string> & labels) const
+{
+	FILE * exportFile = std::fopen(fileName.c_str(), "wb");
+	if(!exportFile)
+	{
+		if(DEBUG)
+			std::cout << "C3D::TrajectoryExporter::write(): Cannot write to the file: " << fileName << std::endl;
+		return false;
+	}
+
+	const char separator = _format == EXPORT_CSV ? ',' : '\t';
+	uint numFrames = trajectory.getNumFrames();
+	uint numMarkers = trajectory.getNumMarkers();
+	std::string header = "frame";
+	for(uint marker = 0; marker < numMarkers; marker++)
+	{
+		std::string label = marker < labels.size() ? labels[marker] : "M" + intToString(trajectory.getMarkerID(marker));
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			header += separator + label + "_" + AXIS_NAMES[axis];
+	}
+	header += "\n";
+	bool success = std::fwrite(header.data(), 1, header.size(), exportFile) == header.size();
+
+	// a row is at most the frame and 3 values per marker, each with its separator
+	std::size_t maxRowSize = (std::size_t(numMarkers) * Marker::NUM_AXES + 1) * (FLOAT_CHARS + 1);
+	std::vector<char> buffer(std::max<std::size_t>(EXPORT_BUFFER_SIZE, 2 * maxRowSize));
+	std::vector<const float *> columns(std::size_t(numMarkers) * Marker::NUM_AXES);
+	for(uint marker = 0; marker < numMarkers; marker++)
+		for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			columns[marker * Marker::NUM_AXES + axis] = trajectory.getColumn(marker, Marker::Axis(axis));
+
+	char * out = buffer.data();
+	char * flushLimit = buffer.data() + buffer.size() - maxRowSize;
+	for(uint frame = 0; frame < numFrames && success; frame++)
+	{
+		out += std::sprintf(out, "%u", trajectory.getFirstFrame() + frame);
+		for(uint marker = 0; marker < numMarkers; marker++)
+		{
+			// invalid samples are stored as NaN
+			for(uint axis = 0; axis < Marker::NUM_AXES; axis++)
+			{
+				*out++ = separator;
+				out = floatToChars(columns[marker * Marker::NUM_AXES + axis][frame], out);
+			}
+		}
+		*out++ = '\n';
+
+		if(out >= flushLimit)
+		{
+			success = std::fwrite(buffer.data(), 1, out - buffer.data(), exportFile) == std::size_t(out - buffer.data());
+			out = buffer.data();
+		}
+	}
+	if(success && out > buffer.data())
+		success = std::fwrite(buffer.data(), 1, out - buffer.data(), exportFile) == std::size_t(out - buffer.data());
+	success = std::fclose(exportFile) == 0 && success;
+
+	if(DEBUG)
+		if(!success)
+			std::cout << "C3D::TrajectoryExporter::write(): Cannot write to the file: " << fileName << std::endl;
+	return success;
+}
+
+uint TrajectoryExporter::writeAll(std::string directory, const std::map<SequenceKey, Marker::Trajectory> & trajectories, const std::vector<std::string> & labels) const
+{
+	std::atomic<uint> numWritten(0);
+	{
+		ThreadPool pool(_numThreads);
+		for(std::map<SequenceKey, Marker::Trajectory>::const_iterator it = trajectories.begin(); it != trajectories.end(); ++it)
+		{
+			std::string fileName = directory + "//" + intToString(it->first.subject) + "_" + intToString(it->first.sequence) + getExtension();
+			const Marker::Trajectory * trajectory = &it->second;
+			pool.submit([this, fileName, trajectory, &labels, &numWritten]()
+			{
+				if(write(fileName, *trajectory, labels))
+					numWritten++;
+			});
+		}
+		pool.wait();
+	}
+	return numWritten;
+}
+
+std::string TrajectoryExporter::getExtension() const
+{
+	return _format == EXPORT_CSV ? ".csv" : ".tsv";
+}
\ No newline at end of file
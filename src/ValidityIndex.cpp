@@ -0,0 +1,164 @@
+///
+/// \file ValidityIndex.cpp
+/// \brief Queries on the valid frames of a trajectory
+/// \author PISUPATI Phanindra
+/// \date 01.04.2014
+///
+
+#include "ValidityIndex.h"
+#include <algorithm>
+
+using namespace Marker;
+
+// --------------------------------------------------------- Constructors
+ValidityIndex::ValidityIndex() :
+	_numFrames(0),
+	_numMarkers(0),
+	_maskWords(0)
+{
+	_gapStart.push_back(0);
+}
+
+ValidityIndex::ValidityIndex(const Trajectory & trajectory)
+{
+	build(trajectory);
+}
+
+// --------------------------------------------------------- Public Functions
+void ValidityIndex::build(const Trajectory & trajectory)
+{
+	_numFrames = trajectory.getNumFrames();
+	_numMarkers = trajectory.getNumMarkers();
+	_maskWords = trajectory.getMaskWords();
+	_validity.resize(std::size_t(_numMarkers) * _maskWords);
+	_prefixCounts.resize(std::size_t(_numMarkers) * (_maskWords + 1));
+	_gaps.clear();
+	_gapStart.clear();
+
+	for(uint marker = 0; marker < _numMarkers; marker++)
+	{
+		const uint64_t * mask = trajectory.getValidityMask(marker);
+		std::copy(mask, mask + _maskWords, _validity.begin() + std::size_t(marker) * _maskWords);
+		uint32_t * prefix = &_prefixCounts[std::size_t(marker) * (_maskWords + 1)];
+		prefix[0] = 0;
+		for(uint word = 0; word < _maskWords; word++)
+			prefix[word + 1] = prefix[word] + __builtin_popcountll(mask[word]);
+
+		// walk the runs a word at a time: skip to the next clear bit, then to the next set bit
+		_gapStart.push_back(_gaps.size());
+		uint frame = 0;
+		while(frame < _numFrames)
+		{
+			uint word = frame / MASK_BITS;
+			uint64_t invalid = ~mask[word] >> (frame % MASK_BITS);
+			if(!invalid)
+			{
+				frame = (word + 1) * MASK_BITS;
+				continue;
+			}
+			frame += __builtin_ctzll(invalid);
+			if(frame >= _numFrames)
+				break;
+
+			uint gapFirst = frame;
+			while(frame < _numFrames)
+			{
+				word = frame / MASK_BITS;
+				uint64_t valid = mask[word] >> (frame % MASK_BITS);
+				if(valid)
+				{
+					frame += __builtin_ctzll(valid);
+					break;
+				}
+				frame = (word + 1) * MASK_BITS;
+			}
+			frame = std::min(frame, _numFrames);
+			_gaps.push_back(FrameRun(gapFirst, frame - gapFirst));
+		}
+	}
+	_gapStart.push_back(_gaps.size());
+}
+
+uint ValidityIndex::countValid(uint marker, uint first, uint last) const
+{
+	last = std::min(last, _numFrames);
+	if(first >= last)
+		return 0;
+	return countBefore(marker, last) - countBefore(marker, first);
+}
+
+bool ValidityIndex::isValid(uint marker, uint first, uint last) const
+{
+	if(last > _numFrames || first > last)
+		return false;
+	return countValid(marker, first, last) == last - first;
+}
+
+bool ValidityIndex::isValid(uint first, uint last) const
+{
+	for(uint marker = 0; marker < _numMarkers; marker++)
+		if(!isValid(marker, first, last))
+			return false;
+	return true;
+}
+
+uint ValidityIndex::getNumGaps(uint marker) const
+{
+	return _gapStart[marker + 1] - _gapStart[marker];
+}
+
+std::vector<FrameRun> ValidityIndex::getGaps(uint marker, uint first, uint last) const
+{
+	std::vector<FrameRun> gaps;
+	last = std::min(last, _numFrames);
+	for(uint gap = findGap(marker, first); gap < _gapStart[marker + 1] && _gaps[gap].first < last; gap++)
+	{
+		uint gapFirst = std::max(_gaps[gap].first, first);
+		uint gapEnd = std::min(_gaps[gap].end(), last);
+		gaps.push_back(FrameRun(gapFirst, gapEnd - gapFirst));
+	}
+	return gaps;
+}
+
+std::vector<FrameRun> ValidityIndex::getValidRuns(uint marker, uint first, uint last) const
+{
+	std::vector<FrameRun> runs;
+	last = std::min(last, _numFrames);
+	uint frame = first;
+	for(uint gap = findGap(marker, first); gap < _gapStart[marker + 1] && _gaps[gap].first < last; gap++)
+	{
+		if(_gaps[gap].first > frame)
+			runs.push_back(FrameRun(frame, _gaps[gap].first - frame));
+		frame = std::max(frame, _gaps[gap].end());
+	}
+	if(frame < last)
+		runs.push_back(FrameRun(frame, last - frame));
+	return runs;
+}
+
+uint ValidityIndex::findNextValid(uint marker, uint frame) const
+{
+	if(frame >= _numFrames)
+		return _numFrames;
+	uint gap = findGap(marker, frame);
+	if(gap < _gapStart[marker + 1] && _gaps[gap].first <= frame)
+		return _gaps[gap].end();
+	return frame;
+}
+
+// --------------------------------------------------------- Private Functions
+uint ValidityIndex::countBefore(uint marker, uint frame) const
+{
+	uint word = frame / MASK_BITS;
+	uint count = _prefixCounts[std::size_t(marker) * (_maskWords + 1) + word];
+	if(frame % MASK_BITS)
+		count += __builtin_popcountll(_validity[std::size_t(marker) * _maskWords + word] & ((uint64_t(1) << (frame % MASK_BITS)) - 1));
+	return count;
+}
+
+uint ValidityIndex::findGap(uint marker, uint frame) const
+{
+	std::vector<FrameRun>::const_iterator begin = _gaps.begin() + _gapStart[marker];
+	std::vector<FrameRun>::const_iterator end = _gaps.begin() + _gapStart[marker + 1];
+	return std::upper_bound(begin, end, frame, [](uint value, const FrameRun & gap) { return value < gap.end(); }) - _gaps.begin();
+}
\ No newline at end of file
@@ -6,12 +6,63 @@
 ///
 
 #include <iostream>
+#include <cstdio>
 #include "Tools.h"
+#include "HeaderTemplateCache.h"
+#include "C3DWriter.h"
+#include "MappedC3DFile.h"
 
 using namespace std;
 
+///
+/// \brief write a capture from a template overridden to other marker counts, re-read it and compare its analog channels to ANALOG:USED
+///	\param templateFileName: c3d file used as template
+///	\return true if every file is consistent
+///
+static bool checkTemplateAnalog(string templateFileName)
+{
+	const uint numFrames = 5;
+	const uint markerCounts[] = {1, 10, 24, 40};
+	string outFileName = templateFileName + ".check.c3d";
+	bool consistent = true;
+	for(uint i = 0; i < sizeof(markerCounts) / sizeof(markerCounts[0]); i++)
+	{
+		uint numMarkers = markerCounts[i];
+		shared_ptr<const UuIcsC3d::C3dFileInfo> fileInfo = C3D::HeaderTemplateCache::get(templateFileName, numMarkers);
+		if(!fileInfo)
+			return false;
+
+		Marker::Trajectory trajectory(numFrames, numMarkers);
+		for(uint frame = 0; frame < numFrames; frame++)
+			for(uint marker = 0; marker < numMarkers; marker++)
+			{
+				Marker::Position position = {float(frame), float(marker), 0.0f};
+				trajectory.setPosition(frame, marker, position);
+			}
+		{
+			C3D::C3DWriter writer(outFileName, *fileInfo);
+			if(!writer.writeFrames(trajectory, 0, numFrames) || !writer.close())
+				return false;
+		}
+
+		C3D::MappedC3DFile file(outFileName);
+		vector<float> used = file.getParameterValues("ANALOG", "USED");
+		uint usedChannels = used.empty() ? 0 : uint(used[0]);
+		uint analogChannels = C3D::MappedC3DFile::getAnalogChannels(file.getFileInfo());
+		bool fileConsistent = file.getNumPoints() == numMarkers && file.getFrameCount() == numFrames && analogChannels == usedChannels;
+		cout << numMarkers << " markers: " << file.getNumPoints() << " points, " << file.getFrameCount() << " frames, "
+			<< analogChannels << " analog channels, ANALOG:USED " << usedChannels << (fileConsistent ? "" : " INCONSISTENT") << endl;
+		consistent = consistent && fileConsistent;
+	}
+	remove(outFileName.c_str());
+	return consistent;
+}
+
 int main(int argc, char ** argv) 
 {
+	if(argc > 2 && string(argv[1]) == "--check-template")
+		return checkTemplateAnalog(argv[2]) ? 0 : 1;
+
 	while(true)
 	{
 		float input;